@@ -10,10 +10,16 @@
 
 #include "Application.hpp"
 #include "AudioSession.hpp"
+#include "Benchmark.hpp"
 #include "Display.hpp"
+#include "Governor.hpp"
+#include "History.hpp"
+#include "Json.hpp"
 #include "MarvinSession.hpp"
 #include "Memory.hpp"
 #include "Mqtt.hpp"
+#include "Power.hpp"
+#include "Telemetry.hpp"
 #include "WiFi.hpp"
 
 #include "Sensors.hpp"
@@ -23,22 +29,42 @@
 extern "C" void app_main()
 {
     std::pmr::set_default_resource(&psram_memory_resource);
+    PowerLock::configure(CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ, 80);
 
-    [[maybe_unused]] Application app{"Office-Aivas-Companion"};
-    [[maybe_unused]] WiFi wiFi{"VillaKunterbunt", "sacomoco02047781"};
-    [[maybe_unused]] Mqtt mqtt{"openhab"};
-    [[maybe_unused]] Sensors sensors;
-    [[maybe_unused]] Display display;
-    [[maybe_unused]] AudioSession audioSession;
-    [[maybe_unused]] MarvinSession marvinSession;
+    // services live in static storage, the main task stack only runs the loop
+    [[maybe_unused]] static Application app{"Office-Aivas-Companion"};
+    [[maybe_unused]] static MemoryGovernor memoryGovernor;
+    [[maybe_unused]] static WiFi wiFi{"VillaKunterbunt", "sacomoco02047781"};
+    [[maybe_unused]] static Mqtt mqtt{"openhab"};
+    [[maybe_unused]] static Telemetry telemetry{Duration::millis(30'000)};
+    [[maybe_unused]] static Sensors sensors;
+    [[maybe_unused]] static History history;
+    static TimeSeries temperatureHistory{
+        "temperature", {.quantum = 0.01f, .deadband = 0.2f, .heartbeat = Duration::millis(600'000)}
+    };
+    static TimeSeries humidityHistory{
+        "humidity", {.quantum = 0.01f, .deadband = 1.0f, .heartbeat = Duration::millis(600'000)}
+    };
+    history.track(temperatureHistory);
+    history.track(humidityHistory);
+    [[maybe_unused]] static Display display;
+    [[maybe_unused]] static AudioSession audioSession;
+    [[maybe_unused]] static MarvinSession marvinSession;
 
-    auto subscription{sensors.radarStateEvent.connect([](bool const state) {
-        ESP_LOGI("AIVAS", "radar sensor state changed to %d", state ? 1 : 0);
+    auto subscription{sensors.radarStateEvent.connect([](Sensors::RadarChange const change) {
+        ESP_LOGI("AIVAS", "radar sensor state changed to %d after %lu ms", change.present ? 1 : 0, change.heldMs);
+        Telemetry::get().metric("radar", change.present);
+        Telemetry::get().metric("radarSuppressed", Sensors::get().radarStats().suppressed);
     })};
 
     Timer radarTimer{"radar", [] {
-        ESP_LOGI("AIVAS", "radar sensor state is %d, temperature %f, hum %f", Sensors::get().radarState(),
-            Sensors::get().temperature(), Sensors::get().humidity());
+        auto const temperature = Sensors::get().temperature();
+        auto const humidity = Sensors::get().humidity();
+        ESP_LOGD("AIVAS", "radar sensor state is %d, temperature %f, hum %f", Sensors::get().radarState(),
+            temperature, humidity);
+        // only meaningful changes and heartbeats go out
+        if (temperatureHistory.add(temperature)) Telemetry::get().metric("temperature", temperature);
+        if (humidityHistory.add(humidity)) Telemetry::get().metric("humidity", humidity);
         if (Sensors::get().radarState()) {
             Display::get().brightness(100);
             Display::get().listen();
@@ -49,5 +75,26 @@ extern "C" void app_main()
     }};
     radarTimer.start(Duration::millis(1000), true);
 
+    Timer memoryTimer{"memory", [memoryTopic = mqtt.topics().add("tele", "MEMORY")] {
+        auto json = jsonDocument();
+        for (auto const tag: memory_tags) {
+            auto const stats = tag->get_stats();
+            json[tag->name()]["live"] = stats.live_bytes;
+            json[tag->name()]["peak"] = stats.peak_bytes;
+            json[tag->name()]["allocs"] = stats.alloc_count;
+            json[tag->name()]["largestFree"] = stats.largest_free_block;
+        }
+        Telemetry::get().publish(memoryTopic, str(json));
+    }};
+    memoryTimer.start(Duration::millis(60'000), true);
+
+    auto pressureSubscription{memoryGovernor.pressureEvent.connect(
+        [pressureTopic = mqtt.topics().add("tele", "PRESSURE")](MemoryGovernor::Pressure const pressure) {
+            // not through telemetry, which the governor sheds right when the pressure rises
+            Mqtt::get().publish(pressureTopic, MemoryGovernor::pressureName(pressure), true, 1);
+        }
+    )};
+
+    benchmark::run();
     app.run();
 }
@@ -1,41 +1,70 @@
 #include <cstdio>
 
+#include <esp_attr.h>
 #include <esp_heap_caps.h>
 #include <esp_log.h>
 #include <esp_system.h>
 
 #include "Application.hpp"
 #include "Memory.hpp"
+#include "Pool.hpp"
+#include "Power.hpp"
 #include "Time.hpp"
 
 static constexpr auto TAG{"Application"};
 
 Application::Application(std::string_view const clientId) noexcept
     : clientId_{clientId},
-      usageTimer_{"usage", &Application::printMemoryUsage}
+      usageTimer_{"usage", &Application::printUsage}
 {
     usageTimer_.start(Duration::millis(5000), true);
+
+    auto const [mpscCycles, ringbufferCycles] = Dispatcher::benchmarkIsrEnqueue();
+    ESP_LOGI(TAG, "isr enqueue: %lu cycles lock-free, %lu cycles ringbuffer", static_cast<unsigned long>(mpscCycles),
+             static_cast<unsigned long>(ringbufferCycles));
 }
 
-void Application::run() const
+void Application::run()
 {
     ESP_LOGI(TAG, "initialization finished, running event loop");
 
     while (true) {
-        if (auto const received = dispatchQueue_.receive()) {
-            (*received)();
-        }
+        dispatcher_.runOne(std::min(timerWheel_.nextTimeout(), executor_.nextTimeout()));
+        timerWheel_.poll();
+        executor_.poll();
     }
 }
 
-void Application::dispatch(Runnable const& runnable) const
+bool Application::dispatch(Runnable const& runnable, Lane const lane, Overflow const overflow)
+{
+    return dispatcher_.dispatch(runnable, lane, overflow);
+}
+
+bool IRAM_ATTR Application::dispatchFromISR(Runnable const& runnable)
+{
+    return dispatcher_.dispatchFromISR(runnable);
+}
+
+bool Application::post(Runnable const& runnable)
+{
+    return dispatcher_.post(runnable);
+}
+
+void Application::wakeup() const
+{
+    dispatcher_.wakeup();
+}
+
+bool Application::submit(Runnable const& job, Runnable const& continuation)
 {
-    dispatchQueue_.emplace(runnable);
+    return workerPool_.submit(job, continuation);
 }
 
-void Application::dispatchFromISR(Runnable const& runnable) const
+void Application::printUsage()
 {
-    (void) dispatchQueue_.sendFromISR(runnable);
+    printMemoryUsage();
+    printDispatchUsage();
+    PowerLock::printUsage();
 }
 
 void Application::printMemoryUsage()
@@ -55,4 +84,40 @@ void Application::printMemoryUsage()
     printf("psram freed:          %u\n", psram_memory_resource.free_count.load());
     printf("internal allocs:      %u\n", internal_memory_resource.alloc_count.load());
     printf("internal freed:       %u\n", internal_memory_resource.free_count.load());
+    printf("psram fallbacks:      %u\n", psram_memory_resource.fallback_count.load());
+    printf("internal fallbacks:   %u\n", internal_memory_resource.fallback_count.load());
+
+    for (auto const tag: memory_tags) {
+        auto const [liveBytes, peakBytes, allocCount, largestFreeBlock] = tag->get_stats();
+        printf("memory %-10s: %7u live, %7u peak, %6u allocs, largest free %7u\n", tag->name(), liveBytes, peakBytes,
+               allocCount, largestFreeBlock);
+    }
+
+    for (std::size_t i = 0; i < small_object_pool.classCount(); ++i) {
+        auto const [blockSize, blockCount, inUse, highWater, allocations, fallbacks] = small_object_pool.stats(i);
+        printf("pool %4u bytes  : %3u/%3u in use, high water %3u, %6u allocs, %u fallbacks\n", blockSize, inUse,
+               blockCount, highWater, allocations, fallbacks);
+    }
+}
+
+void Application::printDispatchUsage()
+{
+    for (auto const lane: {Lane::high, Lane::normal, Lane::low}) {
+        auto const stats = get().dispatcher_.stats(lane);
+        auto const avgLatencyUs = stats.executed > 0 ? stats.totalLatencyUs / stats.executed : 0;
+        printf("dispatch %-6s: %u dispatched, %u dropped, %u coalesced, high water %u, latency %lu/%lu us\n",
+               Dispatcher::laneName(lane), stats.dispatched, stats.dropped, stats.coalesced, stats.highWater,
+               static_cast<unsigned long>(avgLatencyUs), static_cast<unsigned long>(stats.maxLatencyUs));
+    }
+
+    auto const isr = get().dispatcher_.isrStats();
+    auto const enqueues = isr.dispatched + isr.overflows;
+    auto const avgEnqueueCycles = enqueues > 0 ? isr.totalEnqueueCycles / enqueues : 0;
+    printf("dispatch isr   : %u dispatched, %u overflows, enqueue %lu/%lu cycles\n", isr.dispatched, isr.overflows,
+           static_cast<unsigned long>(avgEnqueueCycles), static_cast<unsigned long>(isr.maxEnqueueCycles));
+
+    for (std::size_t i = 0; i < WorkerPool::size(); ++i) {
+        auto const [executed, stolen, rejected] = get().workerPool_.stats(i);
+        printf("worker %u       : %u executed, %u stolen, %u rejected\n", i, executed, stolen, rejected);
+    }
 }
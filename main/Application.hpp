@@ -3,30 +3,50 @@
 
 #include <string_view>
 
+#include "Coroutine.hpp"
+#include "Dispatcher.hpp"
 #include "Function.hpp"
-#include "Queue.hpp"
 #include "Singleton.hpp"
 #include "Timer.hpp"
+#include "TimerWheel.hpp"
+#include "WorkerPool.hpp"
 
 class Application : public Singleton<Application>
 {
     using Runnable = Function<void()>;
 
 public:
+    using Lane = Dispatcher::Lane;
+    using Overflow = Dispatcher::Overflow;
+
     explicit Application(std::string_view clientId) noexcept;
 
     [[nodiscard]] std::string_view clientId() const { return clientId_; }
+    [[nodiscard]] Executor& executor() { return executor_; }
+    [[nodiscard]] TimerWheel& timerWheel() { return timerWheel_; }
+
+    [[noreturn]] void run();
+
+    bool dispatch(Runnable const& runnable, Lane lane = Lane::normal, Overflow overflow = Overflow::block);
+    bool dispatchFromISR(Runnable const& runnable);
+    bool post(Runnable const& runnable);
 
-    [[noreturn]] void run() const;
+    // interrupts the loop's wait so it recomputes its timeouts
+    void wakeup() const;
 
-    void dispatch(Runnable const& runnable) const;
-    void dispatchFromISR(Runnable const& runnable) const;
+    // runs job on a background worker, the continuation is dispatched back to the event loop afterwards
+    bool submit(Runnable const& job, Runnable const& continuation = {});
 
 private:
+    static void printUsage();
     static void printMemoryUsage();
+    static void printDispatchUsage();
 
     std::string_view clientId_;
-    Queue<Runnable> dispatchQueue_{4};
+    Dispatcher dispatcher_{{4, 8, 8}};
+    Executor executor_;
+    TimerWheel timerWheel_;
+    WorkerPool workerPool_{16, 3}; // below the audio tasks
     Timer usageTimer_;
 };
 
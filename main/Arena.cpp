@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cassert>
+
+#include <esp_log.h>
+
+#include "Arena.hpp"
+
+static constexpr auto TAG{"Arena"};
+
+void* SessionArena::Overflow::do_allocate(std::size_t const size, std::size_t const alignment)
+{
+    bytes += size;
+    return upstream_.allocate(size, alignment);
+}
+
+void SessionArena::Overflow::do_deallocate(void* ptr, std::size_t const size, std::size_t const alignment)
+{
+    upstream_.deallocate(ptr, size, alignment);
+}
+
+bool SessionArena::Overflow::do_is_equal(memory_resource const& other) const noexcept
+{
+    return this == &other;
+}
+
+SessionArena::SessionArena(char const* name, std::size_t const capacity, idf_memory_resource_base& upstream)
+    : name_{name},
+      upstream_{upstream},
+      capacity_{capacity},
+      block_{upstream.allocate(capacity, alignof(std::max_align_t))},
+      overflow_{upstream}
+{
+}
+
+SessionArena::~SessionArena()
+{
+    assert(!resource_.has_value());
+    upstream_.deallocate(block_, capacity_, alignof(std::max_align_t));
+}
+
+SessionArena::Stats SessionArena::stats() const
+{
+    return {capacity_, used_, peak_, overflow_.bytes, sessions_};
+}
+
+void* SessionArena::do_allocate(std::size_t const size, std::size_t const alignment)
+{
+    assert(resource_.has_value());
+
+    auto const ptr = resource_->allocate(size, alignment);
+
+    used_ += size;
+    peak_ = std::max(peak_, used_);
+    return ptr;
+}
+
+void SessionArena::do_deallocate(void*, std::size_t, std::size_t)
+{
+}
+
+bool SessionArena::do_is_equal(memory_resource const& other) const noexcept
+{
+    return this == &other;
+}
+
+void SessionArena::begin()
+{
+    assert(!resource_.has_value());
+    used_ = 0;
+    overflow_.bytes = 0;
+    resource_.emplace(block_, capacity_, &overflow_);
+}
+
+void SessionArena::end()
+{
+    resource_.reset();
+    ++sessions_;
+    ESP_LOGI(TAG, "%s session used %u of %u bytes (peak %u, overflow %u)", name_, used_, capacity_, peak_,
+             overflow_.bytes);
+}
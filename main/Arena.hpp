@@ -0,0 +1,89 @@
+#ifndef AIVAS_IOT_ARENA_HPP
+#define AIVAS_IOT_ARENA_HPP
+
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+
+#include "Memory.hpp"
+
+/**
+ * @brief Monotonic arena over a preallocated block, reset in one shot at the end of every session.
+ *
+ * Allocations are only valid within a Scope, everything allocated in it must be gone when it ends. Requests beyond
+ * the block fall back to the upstream resource and are released with the scope as well. Not thread-safe.
+ */
+class SessionArena final : public std::pmr::memory_resource
+{
+    class Overflow final : public std::pmr::memory_resource
+    {
+    public:
+        explicit Overflow(idf_memory_resource_base& upstream) noexcept : upstream_{upstream} {}
+
+        std::size_t bytes{};
+
+    private:
+        void* do_allocate(std::size_t size, std::size_t alignment) override;
+        void do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(memory_resource const& other) const noexcept override;
+
+        idf_memory_resource_base& upstream_;
+    };
+
+public:
+    struct Stats
+    {
+        std::size_t capacity;
+        std::size_t used;          // by the current or last session
+        std::size_t peak;
+        std::size_t overflowBytes; // taken from upstream by the current or last session
+        std::uint32_t sessions;
+    };
+
+    class Scope
+    {
+    public:
+        explicit Scope(SessionArena& arena)
+            : arena_{arena}
+        {
+            arena_.begin();
+        }
+
+        Scope(Scope const&) = delete;
+
+        ~Scope()
+        {
+            arena_.end();
+        }
+
+    private:
+        SessionArena& arena_;
+    };
+
+    SessionArena(char const* name, std::size_t capacity, idf_memory_resource_base& upstream);
+    SessionArena(SessionArena const&) = delete;
+    ~SessionArena() override;
+
+    [[nodiscard]] Scope scope() { return Scope{*this}; }
+    [[nodiscard]] Stats stats() const;
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(memory_resource const& other) const noexcept override;
+
+    void begin();
+    void end();
+
+    char const* name_;
+    idf_memory_resource_base& upstream_;
+    std::size_t capacity_;
+    void* block_;
+    Overflow overflow_;
+    std::optional<std::pmr::monotonic_buffer_resource> resource_;
+    std::size_t used_{};
+    std::size_t peak_{};
+    std::uint32_t sessions_{};
+};
+
+#endif
@@ -22,6 +22,8 @@ void AudioBuffer::push(int16_t const* data)
 
     head_.store(head + 1, std::memory_order_release);
     produced_.fetch_add(1, std::memory_order_relaxed);
+
+    dataEvent_.set();
 }
 
 void AudioBuffer::drop_except_last(std::size_t const count)
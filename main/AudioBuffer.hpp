@@ -6,6 +6,7 @@
 #include <memory_resource>
 #include <vector>
 
+#include "Coroutine.hpp"
 #include "Function.hpp"
 
 class AudioBuffer
@@ -32,6 +33,9 @@ public:
 
     bool pop_nowait(Visitor const& visitor);
 
+    // set on every push, the consumer resets it before draining
+    [[nodiscard]] AsyncEvent& dataEvent() { return dataEvent_; }
+
     Pointer pop();
 
     [[nodiscard]] Stats stats() const;
@@ -54,6 +58,7 @@ private:
     std::pmr::vector<std::int16_t> frames_;
     std::atomic<std::size_t> head_{0};
     std::atomic<std::size_t> tail_{0};
+    AsyncEvent dataEvent_;
 
     std::atomic<std::size_t> produced_{0};
     std::atomic<std::size_t> consumed_{0};
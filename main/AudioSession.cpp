@@ -1,6 +1,9 @@
+#include <algorithm>
+
 #include <bsp/esp-box-3.h>
 #include <esp_afe_sr_models.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 
 #include "AudioSession.hpp"
 #include "Display.hpp"
@@ -17,7 +20,7 @@ static auto initMicrophone()
         .bits_per_sample = sizeof(AudioSession::sample_type) * 8,
         .channel = 2,
         .channel_mask = 0b11,
-        .sample_rate = 16000,
+        .sample_rate = AudioSession::sampleRate,
         .mclk_multiple = 0
     };
     ESP_ERROR_CHECK(esp_codec_dev_open(microphone, &info));
@@ -62,8 +65,8 @@ std::size_t AudioSession::AfeHandle::fetchChannelNum() const { return interface-
 
 AudioSession::AudioSession()
     : microphone_{initMicrophone()},
-      microphoneBuffer_{afeHandle_.feedChannelNum() * afeHandle_.feedChunksize(), &internal_memory_resource},
-      audioBuffer_{16, afeHandle_.fetchChannelNum() * afeHandle_.fetchChunksize(), &psram_memory_resource},
+      microphoneBuffer_{afeHandle_.feedChannelNum() * afeHandle_.feedChunksize(), &audio_internal_memory_resource},
+      audioBuffer_{16, afeHandle_.fetchChannelNum() * afeHandle_.fetchChunksize(), &audio_memory_resource},
       feedTask_{"audioFeed", {*this, &AudioSession::feedTask}, StackDepth{8192}, Priority{5}, Core{0}},
       detectTask_{"audioDetect", {*this, &AudioSession::detectTask}, StackDepth{8192}, Priority{5}, Core{1}}
 {
@@ -83,6 +86,9 @@ void AudioSession::feedTask()
     while (running_) {
         auto const bytes = microphoneBuffer_.size() * sizeof(microphoneBuffer_[0]);
         ESP_ERROR_CHECK(esp_codec_dev_read(microphone_, microphoneBuffer_.data(), bytes));
+
+        // taken once the read returned, the wait for the I2S DMA runs unlocked
+        PowerLockGuard guard{feedLock_};
         afeHandle_.feed(microphoneBuffer_.data());
     }
 }
@@ -94,11 +100,22 @@ void AudioSession::detectTask()
     auto phase{Phase::idle};
     uint32_t dropGuard{};
     uint32_t silenceRun{};
+
+    // real-time headroom: the AFE's input ring fills up when the pipeline falls behind the microphone
+    auto const frameUs = static_cast<std::uint32_t>(afeHandle_.fetchChunksize() * 1'000'000 / sampleRate);
+    auto minFreePct{1.0f};
+    std::uint32_t maxFetchUs{};
     while (running_) {
+        // fetch runs the AFE pipeline (NS, VAD and WakeNet), so the lock has to span it; fetch also waits for the feed
+        // side, which keeps the lock held for most of the session, PowerLock::printUsage shows how much
+        PowerLockGuard guard{detectLock_};
+        auto const fetchStart = esp_timer_get_time();
         auto const result = afeHandle_.fetch();
         if (result == nullptr || result->ret_value == ESP_FAIL) {
             continue;
         }
+        maxFetchUs = std::max(maxFetchUs, static_cast<std::uint32_t>(esp_timer_get_time() - fetchStart));
+        minFreePct = std::min(minFreePct, result->ringbuff_free_pct);
 
         assert(result->data_size == audioBuffer_.frameSize() * sizeof(sample_type));
         audioBuffer_.push(result->data);
@@ -110,6 +127,10 @@ void AudioSession::detectTask()
                      (unsigned)s.size, (unsigned)s.capacity,
                      (unsigned)s.produced, (unsigned)s.consumed,
                      (unsigned)s.overruns, result->data_size);
+            ESP_LOGI(TAG, "afe input ring at least %.0f%% free, fetch took up to %lu us per %lu us frame",
+                     minFreePct * 100.0f, maxFetchUs, frameUs);
+            minFreePct = 1.0f;
+            maxFetchUs = 0;
         }
 
         switch (phase) {
@@ -9,6 +9,7 @@
 
 #include "AudioBuffer.hpp"
 #include "Event.hpp"
+#include "Power.hpp"
 #include "Singleton.hpp"
 #include "Task.hpp"
 
@@ -38,6 +39,7 @@ class AudioSession : public Singleton<AudioSession>
 
 public:
     using sample_type = std::int16_t;
+    static constexpr std::uint32_t sampleRate = 16000;
 
     AudioSession();
     AudioSession(AudioSession const&) = delete;
@@ -57,6 +59,8 @@ private:
     AfeHandle afeHandle_;
     std::pmr::vector<sample_type> microphoneBuffer_;
     AudioBuffer audioBuffer_;
+    PowerLock feedLock_{"audioFeed", ESP_PM_CPU_FREQ_MAX};
+    PowerLock detectLock_{"audioDetect", ESP_PM_CPU_FREQ_MAX};
     Task feedTask_;
     Task detectTask_;
     bool volatile running_{true};
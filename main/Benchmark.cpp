@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <esp_cpu.h>
+#include <esp_log.h>
+
+#include "Benchmark.hpp"
+#include "Event.hpp"
+#include "Json.hpp"
+#include "JsonMessage.hpp"
+#include "Memory.hpp"
+#include "String.hpp"
+#include "TopicTrie.hpp"
+
+static constexpr auto TAG{"Benchmark"};
+static constexpr std::uint32_t iterations = 64;
+
+// keeps the compiler from dropping results nobody reads
+static std::size_t volatile sink;
+
+// average cycles of one call of operation
+template<typename Operation>
+static std::uint32_t measure(Operation&& operation)
+{
+    auto const start = esp_cpu_get_cycle_count();
+    for (std::uint32_t i = 0; i < iterations; ++i) {
+        operation(i);
+    }
+    return (esp_cpu_get_cycle_count() - start) / iterations;
+}
+
+// str() as it was before, appending argument by argument and numbers through to_string
+template<typename... Args>
+static String appendStr(std::pmr::memory_resource* resource, Args const&... args)
+{
+    String result{resource};
+    auto const append = [&](auto const& arg) {
+        if constexpr (std::is_convertible_v<decltype(arg), std::string_view>) {
+            result += std::string_view{arg};
+        } else {
+            result += std::to_string(arg);
+        }
+    };
+    (append(args), ...);
+    return result;
+}
+
+void benchmark::str()
+{
+    // a topic with a numeric suffix and a float payload, as built for telemetry
+    constexpr std::string_view base{"Office/Aivas/Companion"};
+    std::pmr::memory_resource* const resource = &psram_memory_resource;
+    auto const append = measure([&](std::uint32_t const i) {
+        sink = appendStr(resource, "tele/", base, "/SENSOR", i, " ", 21.5f + i).size();
+    });
+    auto const exact = measure([&](std::uint32_t const i) {
+        sink = ::str(resource, "tele/", base, "/SENSOR", i, " ", 21.5f + i).size();
+    });
+    auto const stack = measure([&](std::uint32_t const i) {
+        sink = ::str<64>("tele/", base, "/SENSOR", i, " ", 21.5f + i).size();
+    });
+    ESP_LOGI(TAG, "str: %lu cycles appending, %lu exactly sized, %lu into StaticString", append, exact, stack);
+}
+
+// SubscribeEvent as it was before, handlers in list nodes with a deleted flag each
+template<typename... Args>
+class ListEvent
+{
+    using Handler = Function<void(Args...)>;
+
+public:
+    explicit ListEvent(std::pmr::memory_resource* resource) : handlers_{resource} {}
+
+    void connect(Handler handler) { handlers_.emplace(handlers_.end(), std::move(handler), false); }
+
+    template<typename... T>
+    void operator()(T&&... args)
+    {
+        auto it = handlers_.begin();
+        auto const size = handlers_.size();
+        for (std::size_t i = 0; i < size; ++i) {
+            if (!it->second) it->first(std::forward<T>(args)...);
+            if (it->second) {
+                it = handlers_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+private:
+    std::pmr::list<std::pair<Handler, bool>> handlers_;
+};
+
+void benchmark::emit()
+{
+    // a handful of handlers, like the busiest events in the tree
+    constexpr std::size_t handlerCount = 4;
+    static std::size_t received;
+    auto const handler = [](std::uint32_t const value) { received += value; };
+
+    ListEvent<std::uint32_t> list{&psram_memory_resource};
+    SubscribeEvent<void(std::uint32_t)> table;
+    std::array<Subscription, handlerCount> subscriptions;
+    for (auto& subscription: subscriptions) {
+        list.connect(handler);
+        subscription = table.connect(handler);
+    }
+
+    auto const walk = measure([&](std::uint32_t const i) { list(i); });
+    auto const copyOnWrite = measure([&](std::uint32_t const i) { table(i); });
+    sink = received;
+    ESP_LOGI(TAG, "emit to %u handlers: %lu cycles list walk, %lu copy-on-write table", handlerCount, walk,
+             copyOnWrite);
+}
+
+// Function as it was before, an object or free function pointer plus a member pointer buffer behind one stub
+template<typename Signature>
+class StubFunction;
+
+template<typename Ret, typename... Args>
+class StubFunction<Ret(Args...)>
+{
+    using stub_fn_type = Ret (*)(void* object, void const* member, Args&&... args);
+
+    template<typename T, typename MemFn>
+    static Ret mem_fn_stub(void* object, void const* member, Args&&... args)
+    {
+        return (static_cast<T*>(object)->**static_cast<MemFn const*>(member))(std::forward<Args>(args)...);
+    }
+
+public:
+    template<typename T>
+    StubFunction(T& object, Ret (T::* member)(Args...)) noexcept
+        : object_{&object},
+          stub_fn_{&mem_fn_stub<T, Ret (T::*)(Args...)>}
+    {
+        static_assert(sizeof(member) <= sizeof(member_));
+        std::copy_n(reinterpret_cast<std::byte*>(&member), sizeof(member), member_.data());
+    }
+
+    Ret operator()(Args... args) const { return stub_fn_(object_, member_.data(), std::forward<Args>(args)...); }
+
+private:
+    void* object_;
+    alignas(std::max_align_t) std::array<std::byte, sizeof(void*) * 2> member_{};
+    stub_fn_type stub_fn_;
+};
+
+void benchmark::function()
+{
+    struct Counter
+    {
+        std::uint32_t total;
+
+        void add(std::uint32_t const value) { total += value; }
+    } counter{};
+
+    // copies through a volatile pointer, so the compiler cannot see which target the copy holds
+    auto const copyAndCall = [](auto const& function) {
+        auto const* volatile source = &function;
+        return measure([&](std::uint32_t const i) {
+            auto const copy = *source;
+            copy(i);
+        });
+    };
+
+    // three words, the inline capacity of Function and more than std::function keeps inline on the target
+    std::uint32_t const offset = 1;
+    std::uint32_t const scale = 2;
+    auto const lambda = [&counter, offset, scale](std::uint32_t const value) { counter.add(value * scale + offset); };
+
+    auto const stub = copyAndCall(StubFunction<void(std::uint32_t)>{counter, &Counter::add});
+    auto const member = copyAndCall(fn(counter, &Counter::add));
+    auto const bound = copyAndCall(fn<&Counter::add>(counter));
+    auto const inlineLambda = copyAndCall(Function<void(std::uint32_t)>{lambda});
+    auto const stdLambda = copyAndCall(std::function<void(std::uint32_t)>{lambda});
+    sink = counter.total;
+    ESP_LOGI(TAG, "function copy and call: %lu cycles old stub, %lu member pair, %lu bound member, %lu inline lambda, "
+             "%lu std::function lambda", stub, member, bound, inlineLambda, stdLambda);
+}
+
+void benchmark::jsonMessage()
+{
+    constexpr std::string_view deviceId{"Office-Aivas-Companion"};
+
+    auto const document = measure([&](std::uint32_t) {
+        auto json = jsonDocument();
+        json["type"] = "start";
+        json["deviceId"] = deviceId;
+        json["fmt"] = "pcm16_le";
+        json["sampleRate"] = 16000;
+        json["frameSamples"] = 320;
+        json["channels"] = 1;
+        json["endian"] = "le";
+        json["gain"] = 1.0;
+        sink = to_string(json).size();
+    });
+    auto const message = measure([&](std::uint32_t) {
+        using StartMessage = JsonMessage<
+            "type", "deviceId", "fmt", "sampleRate", "frameSamples", "channels", "endian", "gain"
+        >;
+        std::array<char, 192> buffer; // NOLINT(*-pro-type-member-init)
+        sink = StartMessage::write(buffer, "start", deviceId, "pcm16_le", 16000, 320, 1, "le", 1.0).size();
+    });
+    ESP_LOGI(TAG, "start message: %lu cycles ArduinoJson, %lu JsonMessage", document, message);
+}
+
+void benchmark::topics()
+{
+    // a broker shared by a few hundred rooms, one filter per room and sensor
+    constexpr std::uint32_t rooms = 64;
+    constexpr std::uint32_t sensors = 8;
+    std::pmr::memory_resource* const resource = &psram_memory_resource;
+    auto const topic = [](std::uint32_t const room, std::uint32_t const sensor) {
+        return ::str<32>("aivas/room", room, "/sensor", sensor);
+    };
+
+    std::pmr::multimap<String, std::uint32_t, std::less<>> map{resource};
+    TopicTrie<std::uint32_t> trie{resource};
+    for (std::uint32_t room = 0; room < rooms; ++room) {
+        for (std::uint32_t sensor = 0; sensor < sensors; ++sensor) {
+            map.emplace(String{topic(room, sensor).view(), resource}, sensor);
+            trie.insert(topic(room, sensor).view(), sensor);
+        }
+    }
+
+    std::size_t received{};
+    auto const multimap = measure([&](std::uint32_t const i) {
+        auto const name = topic(i % rooms, i % sensors);
+        auto const [begin, end] = map.equal_range(name.view());
+        std::for_each(begin, end, [&](auto const& pair) { received += pair.second; });
+    });
+    auto const exact = measure([&](std::uint32_t const i) {
+        trie.match(topic(i % rooms, i % sensors).view(), [&](std::uint32_t const value) { received += value; });
+    });
+
+    // a wildcard filter per sensor on top, which the multimap could not route at all
+    for (std::uint32_t sensor = 0; sensor < sensors; ++sensor) {
+        trie.insert(::str<32>("aivas/+/sensor", sensor).view(), sensor);
+    }
+    auto const wildcard = measure([&](std::uint32_t const i) {
+        trie.match(topic(i % rooms, i % sensors).view(), [&](std::uint32_t const value) { received += value; });
+    });
+    sink = received;
+    ESP_LOGI(TAG, "match among %lu filters: %lu cycles multimap, %lu topic trie, %lu topic trie with wildcards",
+             rooms * sensors, multimap, exact, wildcard);
+}
+
+void benchmark::run()
+{
+    str();
+    emit();
+    function();
+    jsonMessage();
+    topics();
+}
@@ -0,0 +1,25 @@
+#ifndef AIVAS_IOT_BENCHMARK_HPP
+#define AIVAS_IOT_BENCHMARK_HPP
+
+/**
+ * @brief Startup measurements of hot paths against the implementations they replaced.
+ *
+ * Every comparison logs the average CPU cycles per operation, which do not depend on the current DFS frequency.
+ * Takes a few milliseconds, run once before the Application loop starts.
+ */
+namespace benchmark {
+    // str() into one exact allocation and into a StaticString against appending argument by argument
+    void str();
+    // SubscribeEvent emission over its copy-on-write table against the list walk it replaced
+    void emit();
+    // copying and calling a Function against the pointer/stub Function it replaced and std::function
+    void function();
+    // the streaming start message through JsonMessage against an ArduinoJson document
+    void jsonMessage();
+    // routing a topic through hundreds of subscriptions in a TopicTrie against the exact match multimap it replaced
+    void topics();
+
+    void run();
+}
+
+#endif
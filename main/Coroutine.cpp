@@ -0,0 +1,122 @@
+#include <utility>
+
+#include "Application.hpp"
+#include "Coroutine.hpp"
+#include "Memory.hpp"
+
+static std::pmr::memory_resource& coroutineResource()
+{
+    static std::pmr::synchronized_pool_resource resource{&events_memory_resource};
+    return resource;
+}
+
+void* Coroutine::promise_type::operator new(std::size_t const size)
+{
+    return coroutineResource().allocate(size);
+}
+
+void Coroutine::promise_type::operator delete(void* ptr, std::size_t const size)
+{
+    coroutineResource().deallocate(ptr, size);
+}
+
+Duration Executor::nextTimeout() const
+{
+    if (sleepers_.empty()) return Duration::max();
+
+    auto const now = xTaskGetTickCount();
+    auto remaining = INT32_MAX;
+    for (auto const& sleeper: sleepers_) {
+        remaining = std::min(remaining, static_cast<std::int32_t>(sleeper.deadline - now));
+    }
+    return remaining > 0 ? Duration::ticks(remaining) : Duration::none();
+}
+
+void Executor::poll()
+{
+    auto const now = xTaskGetTickCount();
+
+    // resumed coroutines may schedule or cancel sleepers, so the scan restarts after each resumption
+    for (auto it = sleepers_.begin(); it != sleepers_.end();) {
+        if (static_cast<std::int32_t>(it->deadline - now) > 0) {
+            ++it;
+            continue;
+        }
+
+        auto const sleeper = *it;
+        sleepers_.erase(it);
+        if (sleeper.event != nullptr) sleeper.event->detach();
+        sleeper.handle.resume();
+        it = sleepers_.begin();
+    }
+}
+
+void Executor::schedule(std::coroutine_handle<> const handle, Duration const timeout, AsyncEvent* event)
+{
+    if (timeout.millis() == Duration::max().millis()) return;
+    sleepers_.push_back({handle, xTaskGetTickCount() + timeout.ticks(), event});
+}
+
+void Executor::cancel(std::coroutine_handle<> const handle)
+{
+    std::erase_if(sleepers_, [handle](auto const& sleeper) { return sleeper.handle == handle; });
+}
+
+bool Executor::OffloadAwaiter::await_suspend(std::coroutine_handle<> const handle)
+{
+    // the coroutine is resumed by the continuation, which the worker pool dispatches back to the loop
+    submitted = Application::get().submit(job, [handle] { handle.resume(); });
+    return submitted;
+}
+
+void AsyncEvent::set()
+{
+    signaled_.store(true);
+    if (waiting_.load()) {
+        Application::get().dispatch(
+            fn<&AsyncEvent::wake>(*this), Application::Lane::high, Application::Overflow::coalesce
+        );
+    }
+}
+
+Subscription AsyncEvent::connect(SubscribeEvent<void()>& event)
+{
+    return event.connect(fn<&AsyncEvent::set>(*this));
+}
+
+bool AsyncEvent::suspend(Awaiter& awaiter, std::coroutine_handle<> const handle)
+{
+    assert(handle_ == nullptr && "only a single coroutine may wait for an AsyncEvent");
+
+    awaiter_ = &awaiter;
+    handle_ = handle;
+    waiting_.store(true);
+
+    // set() might have missed the waiting flag
+    if (signaled_.load()) {
+        detach();
+        return false;
+    }
+
+    Application::get().executor().schedule(handle, awaiter.timeout, this);
+    return true;
+}
+
+void AsyncEvent::wake()
+{
+    if (handle_ == nullptr || !signaled_.load()) return;
+
+    auto const handle = std::exchange(handle_, nullptr);
+    std::exchange(awaiter_, nullptr)->fired = true;
+    waiting_.store(false);
+
+    Application::get().executor().cancel(handle);
+    handle.resume();
+}
+
+void AsyncEvent::detach()
+{
+    waiting_.store(false);
+    awaiter_ = nullptr;
+    handle_ = nullptr;
+}
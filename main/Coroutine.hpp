@@ -0,0 +1,142 @@
+#ifndef AIVAS_IOT_COROUTINE_HPP
+#define AIVAS_IOT_COROUTINE_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <memory_resource>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+
+#include "Event.hpp"
+#include "Function.hpp"
+#include "Time.hpp"
+
+/**
+ * @brief Fire-and-forget coroutine, starts eagerly and frees its frame when it finishes.
+ *
+ * Frames are allocated from a pool resource. Coroutines are meant to be started on the Application loop, all
+ * awaitables below resume them there.
+ */
+class Coroutine
+{
+public:
+    struct promise_type
+    {
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
+        Coroutine get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+class AsyncEvent;
+
+/**
+ * @brief Keeps track of suspended coroutines with a deadline, driven by the Application loop.
+ */
+class Executor
+{
+    friend class AsyncEvent;
+
+    struct Sleeper
+    {
+        std::coroutine_handle<> handle;
+        TickType_t deadline;
+        AsyncEvent* event;
+    };
+
+    struct SleepAwaiter
+    {
+        Executor& executor;
+        Duration timeout;
+
+        [[nodiscard]] bool await_ready() const noexcept { return timeout.millis() == 0; }
+        void await_suspend(std::coroutine_handle<> const handle) const { executor.schedule(handle, timeout, nullptr); }
+        void await_resume() const noexcept {}
+    };
+
+    struct OffloadAwaiter
+    {
+        Function<void()> job;
+        bool submitted{};
+
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        [[nodiscard]] bool await_resume() const noexcept { return submitted; }
+    };
+
+public:
+    Executor() = default;
+    Executor(Executor const&) = delete;
+
+    // time until the earliest deadline, to be used as wait timeout of the loop
+    [[nodiscard]] Duration nextTimeout() const;
+
+    // resumes all coroutines whose deadline expired
+    void poll();
+
+    [[nodiscard]] SleepAwaiter sleep(Duration const timeout) { return {*this, timeout}; }
+
+    // awaitable running job on the worker pool, yields false without suspending if the pool rejected it
+    [[nodiscard]] static OffloadAwaiter offload(Function<void()> const& job) { return {job}; }
+
+private:
+    void schedule(std::coroutine_handle<> handle, Duration timeout, AsyncEvent* event);
+    void cancel(std::coroutine_handle<> handle);
+
+    std::pmr::vector<Sleeper> sleepers_;
+};
+
+/**
+ * @brief Manual-reset event a single coroutine can wait for with a timeout.
+ *
+ * set() may be called from any task, the event has to outlive all calls to it.
+ */
+class AsyncEvent
+{
+    friend class Executor;
+
+    struct Awaiter
+    {
+        AsyncEvent& event;
+        Duration timeout;
+        bool fired{};
+
+        [[nodiscard]] bool await_ready() const noexcept { return event.signaled_.load(); }
+        bool await_suspend(std::coroutine_handle<> const handle) { return event.suspend(*this, handle); }
+        [[nodiscard]] bool await_resume() const noexcept { return fired || event.signaled_.load(); }
+    };
+
+public:
+    AsyncEvent() = default;
+    AsyncEvent(AsyncEvent const&) = delete;
+
+    [[nodiscard]] bool signaled() const { return signaled_.load(); }
+
+    void set();
+    void reset() { signaled_.store(false); }
+
+    // sets the event on every emission of the given event
+    [[nodiscard]] Subscription connect(SubscribeEvent<void()>& event);
+
+    // awaitable yielding true if the event was set, false on timeout
+    [[nodiscard]] Awaiter wait(Duration const timeout = Duration::max()) { return {*this, timeout}; }
+
+private:
+    bool suspend(Awaiter& awaiter, std::coroutine_handle<> handle);
+    void wake();
+    void detach();
+
+    std::atomic<bool> signaled_{};
+    std::atomic<bool> waiting_{};
+    Awaiter* awaiter_{};
+    std::coroutine_handle<> handle_{};
+};
+
+#endif
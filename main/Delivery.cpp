@@ -0,0 +1,40 @@
+#include "Application.hpp"
+#include "Delivery.hpp"
+
+LoopDelivery loopDelivery;
+WorkerDelivery workerDelivery;
+
+bool LoopDelivery::post(Runnable const& runnable)
+{
+    return Application::get().post(runnable);
+}
+
+bool WorkerDelivery::post(Runnable const& runnable)
+{
+    return Application::get().submit(runnable);
+}
+
+bool Mailbox::post(Runnable const& runnable)
+{
+    // the owner spins on claimed cells, so the push must not be preempted
+    auto const state = portSET_INTERRUPT_MASK_FROM_ISR();
+    auto const pushed = queue_.push(runnable);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+
+    if (pushed == MpscQueue<Runnable, capacity>::Pushed::first) {
+        if (auto const owner = owner_.load(std::memory_order_acquire); owner != nullptr) xTaskNotifyGive(owner);
+    }
+    return pushed != MpscQueue<Runnable, capacity>::Pushed::overflow;
+}
+
+std::size_t Mailbox::process(Duration const timeout)
+{
+    owner_.store(xTaskGetCurrentTaskHandle(), std::memory_order_release);
+    if (queue_.size() == 0) ulTaskNotifyTake(pdTRUE, timeout.ticks());
+
+    std::size_t processed{};
+    for (Runnable runnable; queue_.pop(runnable); ++processed) {
+        runnable();
+    }
+    return processed;
+}
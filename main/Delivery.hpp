@@ -0,0 +1,67 @@
+#ifndef AIVAS_IOT_DELIVERY_HPP
+#define AIVAS_IOT_DELIVERY_HPP
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "Function.hpp"
+#include "MpscQueue.hpp"
+#include "Time.hpp"
+
+/**
+ * @brief Executor that queued event handlers are posted to, post() must never block.
+ */
+class DeliveryTarget
+{
+public:
+    using Runnable = Function<void()>;
+
+    virtual bool post(Runnable const& runnable) = 0;
+
+protected:
+    ~DeliveryTarget() = default;
+};
+
+/**
+ * @brief Runs posted handlers on the Application loop.
+ */
+struct LoopDelivery final : DeliveryTarget
+{
+    bool post(Runnable const& runnable) override;
+};
+
+/**
+ * @brief Runs posted handlers on the Application's worker pool.
+ */
+struct WorkerDelivery final : DeliveryTarget
+{
+    bool post(Runnable const& runnable) override;
+};
+
+/**
+ * @brief Lock-free inbox of a specific task, which drains it by calling process().
+ */
+class Mailbox final : public DeliveryTarget
+{
+    static constexpr std::size_t capacity = 16;
+
+public:
+    Mailbox() = default;
+    Mailbox(Mailbox const&) = delete;
+
+    bool post(Runnable const& runnable) override;
+
+    // runs all posted handlers, waits up to timeout for the first one; must always be called by the same task
+    std::size_t process(Duration timeout = Duration::none());
+
+    [[nodiscard]] std::size_t overflows() const { return queue_.overflows(); }
+
+private:
+    MpscQueue<Runnable, capacity> queue_;
+    std::atomic<TaskHandle_t> owner_{};
+};
+
+extern LoopDelivery loopDelivery;
+extern WorkerDelivery workerDelivery;
+
+#endif
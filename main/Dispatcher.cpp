@@ -0,0 +1,191 @@
+#include <esp_attr.h>
+#include <esp_cpu.h>
+#include <esp_timer.h>
+
+#include "Dispatcher.hpp"
+#include "Queue.hpp"
+
+Dispatcher::Dispatcher(std::array<std::size_t, laneCount> const& capacities)
+    : consumer_{xTaskGetCurrentTaskHandle()}
+{
+    for (std::size_t i = 0; i < laneCount; ++i) {
+        auto& lane = lanes_[i];
+        lane.entries.resize(capacities[i]);
+        lane.slots = xSemaphoreCreateCounting(capacities[i], capacities[i]);
+        configASSERT(lane.slots != nullptr);
+    }
+}
+
+Dispatcher::~Dispatcher()
+{
+    for (auto const& lane: lanes_) {
+        vSemaphoreDelete(lane.slots);
+    }
+}
+
+bool Dispatcher::dispatch(Runnable const& runnable, Lane const lane, Overflow const overflow)
+{
+    auto& state = lanes_[static_cast<std::size_t>(lane)];
+
+    // the slot is taken first, since taking it may block; checking for a pending copy and enqueuing then happen in
+    // one critical section, so two coalescing dispatchers cannot both miss each other's runnable
+    auto const timeout = overflow == Overflow::block ? Duration::max() : Duration::none();
+    auto const slot = xSemaphoreTake(state.slots, timeout.ticks()) == pdTRUE;
+
+    taskENTER_CRITICAL(&lock_);
+    auto const coalesced = overflow == Overflow::coalesce && pending(state, runnable);
+    if (coalesced) {
+        ++state.stats.coalesced;
+    } else if (slot) {
+        enqueue(state, runnable);
+    } else {
+        ++state.stats.dropped;
+    }
+    taskEXIT_CRITICAL(&lock_);
+
+    if (coalesced) {
+        if (slot) xSemaphoreGive(state.slots);
+        return true;
+    }
+    if (!slot) return false;
+
+    xTaskNotifyGive(consumer_);
+    return true;
+}
+
+bool IRAM_ATTR Dispatcher::dispatchFromISR(Runnable const& runnable)
+{
+    auto const start = esp_cpu_get_cycle_count();
+    auto const pushed = isrQueue_.push(runnable);
+    auto const cycles = esp_cpu_get_cycle_count() - start;
+
+    isrTotalEnqueueCycles_.fetch_add(cycles, std::memory_order_relaxed);
+    if (cycles > isrMaxEnqueueCycles_.load(std::memory_order_relaxed)) {
+        isrMaxEnqueueCycles_.store(cycles, std::memory_order_relaxed);
+    }
+    if (pushed == MpscQueue<Runnable, isrCapacity>::Pushed::overflow) return false;
+
+    isrDispatched_.fetch_add(1, std::memory_order_relaxed);
+    if (pushed == MpscQueue<Runnable, isrCapacity>::Pushed::first) {
+        BaseType_t woken{};
+        vTaskNotifyGiveFromISR(consumer_, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+    return true;
+}
+
+bool Dispatcher::post(Runnable const& runnable)
+{
+    // the consumer spins on claimed cells, so the push must not be preempted
+    auto const state = portSET_INTERRUPT_MASK_FROM_ISR();
+    auto const pushed = isrQueue_.push(runnable);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+
+    if (pushed == MpscQueue<Runnable, isrCapacity>::Pushed::overflow) return false;
+    if (pushed == MpscQueue<Runnable, isrCapacity>::Pushed::first) xTaskNotifyGive(consumer_);
+    return true;
+}
+
+bool Dispatcher::runOne(Duration const timeout)
+{
+    if (ulTaskNotifyTake(pdFALSE, timeout.ticks()) == 0) return false;
+
+    // the ISR queue signals only its empty to non-empty transition, so it is drained completely on every wakeup
+    Runnable runnable;
+    auto ranAny = false;
+    while (isrQueue_.pop(runnable)) {
+        runnable();
+        ranAny = true;
+    }
+
+    LaneState* source{};
+
+    taskENTER_CRITICAL(&lock_);
+    for (auto& lane: lanes_) {
+        if (lane.head == lane.tail) continue;
+
+        auto const& entry = lane.entries[lane.tail++ % lane.entries.size()];
+        auto const latency = static_cast<std::uint32_t>(esp_timer_get_time() - entry.enqueuedAt);
+        ++lane.stats.executed;
+        lane.stats.totalLatencyUs += latency;
+        lane.stats.maxLatencyUs = std::max(lane.stats.maxLatencyUs, latency);
+        runnable = entry.runnable;
+        source = &lane;
+        break;
+    }
+    taskEXIT_CRITICAL(&lock_);
+
+    if (source == nullptr) return ranAny;
+
+    xSemaphoreGive(source->slots);
+    runnable();
+    return true;
+}
+
+Dispatcher::Stats Dispatcher::stats(Lane const lane) const
+{
+    taskENTER_CRITICAL(&lock_);
+    auto const result = lanes_[static_cast<std::size_t>(lane)].stats;
+    taskEXIT_CRITICAL(&lock_);
+    return result;
+}
+
+Dispatcher::IsrStats Dispatcher::isrStats() const
+{
+    return {
+        isrDispatched_.load(std::memory_order_relaxed),
+        isrQueue_.overflows(),
+        isrMaxEnqueueCycles_.load(std::memory_order_relaxed),
+        isrTotalEnqueueCycles_.load(std::memory_order_relaxed),
+    };
+}
+
+Dispatcher::IsrBenchmark Dispatcher::benchmarkIsrEnqueue()
+{
+    // the ringbuffer is the path dispatchFromISR took before, Queue<void>::sendFromISR copies the runnable bytewise
+    MpscQueue<Runnable, isrCapacity> mpsc;
+    Queue<void> ringbuffer{isrCapacity, sizeof(Runnable)};
+    Runnable const runnable{[] {}};
+
+    auto const measure = [](auto const& push) {
+        std::uint32_t total{};
+        for (std::size_t i = 0; i < isrCapacity; ++i) {
+            auto const state = portSET_INTERRUPT_MASK_FROM_ISR();
+            auto const start = esp_cpu_get_cycle_count();
+            push();
+            total += esp_cpu_get_cycle_count() - start;
+            portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+        }
+        return static_cast<std::uint32_t>(total / isrCapacity);
+    };
+
+    return {
+        measure([&] { mpsc.push(runnable); }),
+        measure([&] { ringbuffer.sendFromISR(&runnable); }),
+    };
+}
+
+char const* Dispatcher::laneName(Lane const lane)
+{
+    switch (lane) {
+        case Lane::high: return "high";
+        case Lane::normal: return "normal";
+        case Lane::low: return "low";
+    }
+    return "?";
+}
+
+bool Dispatcher::pending(LaneState const& lane, Runnable const& runnable) const
+{
+    for (auto seq = lane.tail; seq != lane.head; ++seq) {
+        if (lane.entries[seq % lane.entries.size()].runnable == runnable) return true;
+    }
+    return false;
+}
+
+void IRAM_ATTR Dispatcher::enqueue(LaneState& lane, Runnable const& runnable)
+{
+    lane.entries[lane.head++ % lane.entries.size()] = {runnable, esp_timer_get_time()};
+    ++lane.stats.dispatched;
+    lane.stats.highWater = std::max(lane.stats.highWater, lane.head - lane.tail);
+}
@@ -0,0 +1,119 @@
+#ifndef AIVAS_IOT_DISPATCHER_HPP
+#define AIVAS_IOT_DISPATCHER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "Function.hpp"
+#include "MpscQueue.hpp"
+#include "Time.hpp"
+
+/**
+ * @brief Multi-lane run queue consumed by a single task, lanes are drained in order of priority.
+ *
+ * The consuming task is the one constructing the dispatcher. Runnables dispatched from ISRs bypass the lanes through a
+ * lock-free queue and run ahead of all lanes.
+ */
+class Dispatcher
+{
+public:
+    using Runnable = Function<void()>;
+
+    enum class Lane : std::uint8_t { high, normal, low };
+
+    enum class Overflow : std::uint8_t
+    {
+        block,   // wait for a free slot
+        drop,    // discard the runnable if the lane is full
+        coalesce // discard the runnable if an identical one is pending, otherwise drop on overflow
+    };
+
+    static constexpr std::size_t laneCount = 3;
+    static constexpr std::size_t isrCapacity = 16;
+
+    struct Stats
+    {
+        std::size_t dispatched;
+        std::size_t executed;
+        std::size_t dropped;
+        std::size_t coalesced;
+        std::size_t highWater;
+        std::uint32_t maxLatencyUs;
+        std::uint64_t totalLatencyUs;
+    };
+
+    struct IsrStats
+    {
+        std::size_t dispatched;
+        std::size_t overflows;
+        std::uint32_t maxEnqueueCycles;
+        std::uint64_t totalEnqueueCycles;
+    };
+
+    // average cycles of one enqueue with interrupts masked, for the lock-free queue and a FreeRTOS ringbuffer
+    struct IsrBenchmark
+    {
+        std::uint32_t mpscCycles;
+        std::uint32_t ringbufferCycles;
+    };
+
+    explicit Dispatcher(std::array<std::size_t, laneCount> const& capacities);
+    Dispatcher(Dispatcher const&) = delete;
+    ~Dispatcher();
+
+    bool dispatch(Runnable const& runnable, Lane lane, Overflow overflow);
+    bool dispatchFromISR(Runnable const& runnable);
+
+    // lock-free counterpart of dispatch for tasks that must not block, shares the queue with dispatchFromISR
+    bool post(Runnable const& runnable);
+
+    // makes a pending or upcoming runOne return, possibly without running anything
+    void wakeup() const { xTaskNotifyGive(consumer_); }
+
+    // runs the next pending runnable, returns false if there was none within timeout
+    bool runOne(Duration timeout = Duration::max());
+
+    [[nodiscard]] Stats stats(Lane lane) const;
+    [[nodiscard]] IsrStats isrStats() const;
+
+    static char const* laneName(Lane lane);
+
+    // fills a scratch queue of each kind to isrCapacity, takes well under a millisecond
+    static IsrBenchmark benchmarkIsrEnqueue();
+
+private:
+    struct Entry
+    {
+        Runnable runnable;
+        std::int64_t enqueuedAt;
+    };
+
+    struct LaneState
+    {
+        std::pmr::vector<Entry> entries;
+        std::size_t head{};
+        std::size_t tail{};
+        SemaphoreHandle_t slots{};
+        Stats stats{};
+    };
+
+    [[nodiscard]] bool pending(LaneState const& lane, Runnable const& runnable) const;
+    void enqueue(LaneState& lane, Runnable const& runnable);
+
+    TaskHandle_t consumer_;
+    std::array<LaneState, laneCount> lanes_;
+    MpscQueue<Runnable, isrCapacity> isrQueue_;
+    std::atomic<std::size_t> isrDispatched_{};
+    std::atomic<std::uint32_t> isrMaxEnqueueCycles_{};
+    std::atomic<std::uint64_t> isrTotalEnqueueCycles_{}; // not lock-free on Xtensa, libatomic masks interrupts
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+};
+
+#endif
@@ -1,11 +1,10 @@
+#include <algorithm>
+
 #include <bsp/esp-box-3.h>
+#include <freertos/FreeRTOS.h>
 
 #include "Display.hpp"
-
-#include <functional>
-#include <memory>
-
-#include "Memory.hpp"
+#include "Governor.hpp"
 
 static constexpr auto TAG = "Display";
 
@@ -57,38 +56,153 @@ Display::Display()
     img_listen_ = lv_img_create(screen);
     lv_img_set_src(img_listen_, &body_eye_screen);
     lv_obj_align(img_listen_, LV_ALIGN_TOP_LEFT, 130, 110);
-    auto const img_eyes_listen = lv_img_create(img_listen_);
-    lv_img_set_src(img_eyes_listen, &eyes_listen);
-    lv_obj_align(img_eyes_listen, LV_ALIGN_TOP_LEFT, 19,10);
+    img_eyes_listen_ = lv_img_create(img_listen_);
+    lv_img_set_src(img_eyes_listen_, &eyes_listen);
+    lv_obj_align(img_eyes_listen_, LV_ALIGN_TOP_LEFT, 19,10);
     lv_obj_set_flag(img_listen_, LV_OBJ_FLAG_HIDDEN, true);
 
+    label_text_ = lv_label_create(screen);
+    lv_obj_align(label_text_, LV_ALIGN_BOTTOM_MID, 0, -12);
+    lv_obj_set_flag(label_text_, LV_OBJ_FLAG_HIDDEN, true);
+
+    timer_ = lv_timer_create(&Display::frame, interval_.millis(), this);
+
     bsp_display_unlock();
 
+    animation(Animation::blink);
+
+    MemoryGovernor::get().addFeature("animation", MemoryGovernor::animationRank, fn<&Display::shedAnimation>(*this));
+
     ESP_LOGI(TAG, "display successfully initialized");
 }
 
-// ReSharper disable once CppMemberFunctionMayBeStatic
-void Display::brightness(int const level) // NOLINT(*-convert-member-functions-to-static)
+void Display::brightness(int const level)
 {
-    ESP_ERROR_CHECK(bsp_display_brightness_set(level));
+    brightness_.store(level, std::memory_order_relaxed);
+    post(Property::brightness);
 }
 
-void Display::showText(String const& text) const
+void Display::showText(std::string_view const text)
 {
+    taskENTER_CRITICAL(&textLock_);
+    auto const buffer = text_.prepare(text.size());
+    std::copy_n(text.data(), buffer.size(), buffer.data());
+    taskEXIT_CRITICAL(&textLock_);
+    post(Property::text);
 }
 
-void Display::listen() const
+void Display::animation(Animation const animation)
 {
-    bsp_display_lock(0);
-    lv_obj_set_flag(img_sleep_, LV_OBJ_FLAG_HIDDEN, true);
-    lv_obj_set_flag(img_listen_, LV_OBJ_FLAG_HIDDEN, false);
-    bsp_display_unlock();
+    animation_.store(animation, std::memory_order_relaxed);
+    post(Property::animation);
 }
 
-void Display::sleep() const
+void Display::mode(Mode const mode)
 {
-    bsp_display_lock(0);
-    lv_obj_set_flag(img_sleep_, LV_OBJ_FLAG_HIDDEN, false);
-    lv_obj_set_flag(img_listen_, LV_OBJ_FLAG_HIDDEN, true);
-    bsp_display_unlock();
+    mode_.store(mode, std::memory_order_relaxed);
+    post(Property::mode);
+}
+
+Display::Stats Display::stats() const
+{
+    return {
+        requested_.load(std::memory_order_relaxed),
+        skipped_.load(std::memory_order_relaxed),
+        coalesced_.load(std::memory_order_relaxed),
+        frames_.load(std::memory_order_relaxed),
+    };
+}
+
+void Display::frame(lv_timer_t* timer)
+{
+    static_cast<Display*>(lv_timer_get_user_data(timer))->render();
+}
+
+void Display::post(Property const property)
+{
+    // the value is stored before the bit is set, so a frame that sees the bit also sees the value
+    auto const bit = 1u << static_cast<unsigned>(property);
+    requested_.fetch_add(1, std::memory_order_relaxed);
+    if ((posted_.fetch_or(bit, std::memory_order_release) & bit) != 0) {
+        coalesced_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool Display::fold(Property const property)
+{
+    auto const assign = [](auto& field, auto const& value) {
+        if (field == value) return false;
+        field = value;
+        return true;
+    };
+
+    switch (property) {
+        case Property::mode: return assign(desired_.mode, mode_.load(std::memory_order_relaxed));
+        case Property::brightness: return assign(desired_.brightness, brightness_.load(std::memory_order_relaxed));
+        case Property::animation: return assign(desired_.animation, animation_.load(std::memory_order_relaxed));
+        case Property::text: {
+            taskENTER_CRITICAL(&textLock_);
+            auto const text = text_;
+            taskEXIT_CRITICAL(&textLock_);
+            return assign(desired_.text, text);
+        }
+    }
+    return false;
+}
+
+void Display::render()
+{
+    // runs inside lv_timer_handler, the LVGL lock is already held
+    auto const posted = posted_.exchange(0, std::memory_order_acquire);
+    auto changed = false;
+    for (auto const property: {Property::mode, Property::brightness, Property::text, Property::animation}) {
+        if ((posted & 1u << static_cast<unsigned>(property)) == 0) continue;
+        if (fold(property)) {
+            changed = true;
+        } else {
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (changed) {
+        frames_.fetch_add(1, std::memory_order_relaxed);
+        if (desired_.mode != applied_.mode) {
+            lv_obj_set_flag(img_sleep_, LV_OBJ_FLAG_HIDDEN, desired_.mode != Mode::sleep);
+            lv_obj_set_flag(img_listen_, LV_OBJ_FLAG_HIDDEN, desired_.mode != Mode::listen);
+        }
+        if (desired_.brightness != applied_.brightness) {
+            ESP_ERROR_CHECK(bsp_display_brightness_set(desired_.brightness));
+        }
+        if (!(desired_.text == applied_.text)) {
+            lv_label_set_text(label_text_, desired_.text.c_str());
+            lv_obj_set_flag(label_text_, LV_OBJ_FLAG_HIDDEN, desired_.text.size() == 0);
+        }
+        applied_ = desired_;
+    }
+
+    // changes tend to come in bursts, an idle display only needs to look for posted properties now and then
+    auto const animating = animate();
+    auto const interval = changed || animating ? frameInterval : idleFrameInterval;
+    if (interval != interval_) {
+        lv_timer_set_period(timer_, interval.millis());
+        interval_ = interval;
+    }
+}
+
+bool Display::animate()
+{
+    auto const blink = applied_.mode == Mode::listen && applied_.animation == Animation::blink
+                       && !animationShed_.load(std::memory_order_relaxed);
+    auto const frame = blink ? animationFrame_++ % blinkPeriodFrames : 0;
+    auto const closed = blink && frame < blinkFrames;
+    if (closed != blinking_) {
+        lv_img_set_src(img_eyes_listen_, closed ? &eyes_listen_2 : &eyes_listen);
+        blinking_ = closed;
+    }
+    return blink;
+}
+
+void Display::shedAnimation(bool const shed)
+{
+    animationShed_.store(shed, std::memory_order_relaxed);
 }
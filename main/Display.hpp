@@ -1,27 +1,111 @@
 #ifndef AIVAS_IOT_DISPLAY_HPP
 #define AIVAS_IOT_DISPLAY_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+#include <freertos/FreeRTOS.h>
 #include <misc/lv_types.h>
 
 #include "Singleton.hpp"
 #include "String.hpp"
+#include "Time.hpp"
 
+/**
+ * @brief Declarative display state, changed through one latest-value slot per property.
+ *
+ * The setters never wait on the display and may be called from any task, including the audio tasks: scalars are
+ * stored atomically, the text is copied under a spinlock that is never held longer than that copy. A timer on the
+ * LVGL task collects the properties posted since the last frame, compares them with the applied state and touches
+ * only the objects that actually changed, all under the LVGL lock the task already holds. The newest value of a
+ * property always wins; values that do not change the state are counted as skipped, values overwritten before a
+ * frame picked them up as coalesced. While nothing is posted and no animation runs, the timer slows down to
+ * idleFrameInterval, the setters cannot wake it since they must not touch LVGL.
+ */
 class Display : public Singleton<Display>
 {
+    static constexpr auto frameInterval = Duration::millis(33);
+    static constexpr auto idleFrameInterval = Duration::millis(200); // bounds the latency of the first change
+    static constexpr std::uint32_t blinkPeriodFrames = 90; // about 3 s
+    static constexpr std::uint32_t blinkFrames = 5;
+    static constexpr std::size_t textCapacity = 63;
+
 public:
+    enum class Mode : std::uint8_t { sleep, listen };
+    enum class Animation : std::uint8_t { none, blink };
+
+    using Text = StaticString<textCapacity>;
+
+    struct State
+    {
+        Mode mode;
+        int brightness;
+        Text text;
+        Animation animation;
+    };
+
+    struct Stats
+    {
+        std::uint32_t requested;
+        std::uint32_t skipped;   // did not change the desired state
+        std::uint32_t coalesced; // overwritten before a frame picked it up
+        std::uint32_t frames;    // frames that applied a change
+    };
+
     Display();
     Display(Display const&) = delete;
 
     void brightness(int level);
+    void showText(std::string_view text);
+    void animation(Animation animation);
 
-    void showText(String const& text) const;
+    void listen() { mode(Mode::listen); }
+    void sleep() { mode(Mode::sleep); }
+    void mode(Mode mode);
 
-    void listen() const;
-    void sleep() const;
+    [[nodiscard]] Stats stats() const;
 
 private:
+    enum class Property : std::uint8_t { mode, brightness, text, animation };
+
+    static void frame(lv_timer_t* timer);
+
+    // marks the property's slot as written
+    void post(Property property);
+    // takes the property's latest value, returns false if it did not change the desired state
+    bool fold(Property property);
+
+    void render();
+    // returns true while the animation needs every frame
+    bool animate();
+    void shedAnimation(bool shed);
+
     lv_obj_t* img_sleep_{};
     lv_obj_t* img_listen_{};
+    lv_obj_t* img_eyes_listen_{};
+    lv_obj_t* label_text_{};
+    lv_timer_t* timer_{};
+    Duration interval_{frameInterval};
+
+    std::atomic<std::uint32_t> posted_{}; // bit per Property written since the last frame
+    std::atomic<Mode> mode_{Mode::sleep};
+    std::atomic<int> brightness_{100};
+    std::atomic<Animation> animation_{Animation::none};
+    mutable portMUX_TYPE textLock_ = portMUX_INITIALIZER_UNLOCKED;
+    Text text_;
+
+    std::atomic<std::uint32_t> requested_{};
+    std::atomic<std::uint32_t> skipped_{};
+    std::atomic<std::uint32_t> coalesced_{};
+    std::atomic<std::uint32_t> frames_{};
+
+    // owned by the LVGL task, applied_ matches what the constructor built
+    State desired_{Mode::sleep, 100, {}, Animation::none};
+    State applied_{Mode::sleep, 100, {}, Animation::none};
+    std::uint32_t animationFrame_{};
+    bool blinking_{};
+    std::atomic<bool> animationShed_{};
 };
 
 #endif
@@ -1,10 +1,19 @@
 #ifndef ESPIDF_IOT_EVENT_HPP
 #define ESPIDF_IOT_EVENT_HPP
 
+#include "Delivery.hpp"
 #include "Function.hpp"
+#include "Pool.hpp"
 
-#include <list>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <tuple>
+#include <new>
+#include <span>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -34,44 +43,273 @@ private:
     std::pmr::vector<Handler> handlers_;
 };
 
-using Subscription = std::unique_ptr<bool, void (*)(bool* deleted)>;
+/**
+ * @brief Handle of a SubscribeEvent connection, disconnects when destroyed. Must not outlive the event.
+ */
+class Subscription
+{
+    using Disconnect = void (*)(void* event, std::uint32_t id);
+
+public:
+    Subscription() = default;
+
+    Subscription(void* event, Disconnect const disconnect, std::uint32_t const id) noexcept
+        : event_{event},
+          disconnect_{disconnect},
+          id_{id}
+    {
+    }
 
+    Subscription(Subscription&& other) noexcept
+        : event_{std::exchange(other.event_, nullptr)},
+          disconnect_{other.disconnect_},
+          id_{other.id_}
+    {
+    }
+
+    Subscription& operator=(Subscription&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            event_ = std::exchange(other.event_, nullptr);
+            disconnect_ = other.disconnect_;
+            id_ = other.id_;
+        }
+        return *this;
+    }
+
+    ~Subscription() { reset(); }
+
+    void reset()
+    {
+        if (event_ != nullptr) disconnect_(std::exchange(event_, nullptr), id_);
+    }
+
+private:
+    void* event_{};
+    Disconnect disconnect_{};
+    std::uint32_t id_{};
+};
+
+/**
+ * @brief Event with handlers stored in a flat table that is replaced copy-on-write.
+ *
+ * Emission never locks and may run concurrently to connect and disconnect on other tasks. It iterates a snapshot of
+ * the table, so handlers added meanwhile are not invoked, handlers removed meanwhile are skipped. Replaced tables are
+ * reclaimed by the next modification that sees no emission in progress.
+ *
+ * Handlers connected with a DeliveryTarget are queued: the arguments are copied into one of a fixed number of pooled
+ * envelopes which is posted to the target, so emission never waits for the subscriber. Emissions that find no free
+ * envelope or a full target are dropped and counted. The envelopes are allocated with the first queued handler, events
+ * that only call handlers directly carry none.
+ */
 template<typename Signature>
-class SubscribeEvent
+class SubscribeEvent;
+
+template<typename... Args>
+class SubscribeEvent<void(Args...)>
 {
-    using Handler = Function<Signature>;
+    static constexpr std::size_t envelopeCount = 8;
+
+    using Handler = Function<void(Args...)>;
+
+    struct Slot
+    {
+        Handler handler;
+        DeliveryTarget* target;
+        std::uint32_t id;
+        std::atomic<bool> removed;
+    };
+
+    struct Envelope
+    {
+        SubscribeEvent* event;
+        Handler handler;
+        std::uint32_t id;
+        std::tuple<std::decay_t<Args>...> args;
+        std::atomic<bool> used;
+
+        void deliver()
+        {
+            // the subscriber might have disconnected while the envelope was queued
+            if (event->connected(id)) std::apply(handler, args);
+            used.store(false, std::memory_order_release);
+        }
+    };
+
+    struct alignas(Slot) Table
+    {
+        std::size_t capacity;
+        std::size_t size;
+        Table* retired;
+
+        Slot* begin() { return reinterpret_cast<Slot*>(this + 1); }
+        Slot* end() { return begin() + size; }
+    };
 
 public:
     SubscribeEvent() = default;
     SubscribeEvent(SubscribeEvent const&) = delete;
 
-    [[nodiscard]] Subscription connect(Handler handler)
+    ~SubscribeEvent()
+    {
+        release(table_.load());
+        reclaim(true);
+        if (auto const envelopes = envelopes_.load(); envelopes != nullptr) {
+            std::destroy_n(envelopes, envelopeCount);
+            resource_->deallocate(envelopes, envelopeCount * sizeof(Envelope), alignof(Envelope));
+        }
+    }
+
+    [[nodiscard]] Subscription connect(Handler handler, DeliveryTarget* target = nullptr)
     {
-        auto it = handlers_.emplace(handlers_.end(), std::move(handler), false);
-        return {&it->second, [](auto deleted) { *deleted = true; }};
+        std::lock_guard lock{mutex_};
+        // published before the table, an emission that sees the slot sees the envelopes
+        if (target != nullptr && envelopes_.load(std::memory_order_relaxed) == nullptr) {
+            auto const envelopes = static_cast<Envelope*>(
+                resource_->allocate(envelopeCount * sizeof(Envelope), alignof(Envelope))
+            );
+            std::uninitialized_value_construct_n(envelopes, envelopeCount);
+            envelopes_.store(envelopes, std::memory_order_release);
+        }
+        auto const id = nextId_++;
+        auto const old = table_.load();
+        auto const table = copy(old, 0, 1);
+        new(table->begin() + table->size++) Slot{handler, target, id, false};
+        publish(table, old);
+        return {this, &SubscribeEvent::disconnect, id};
+    }
+
+    [[nodiscard]] Subscription connect(Handler handler, DeliveryTarget& target)
+    {
+        return connect(handler, &target);
     }
 
     template<typename... T>
     void operator()(T&&... args)
     {
-        // elements added inside handlers should not be invoked
-        auto it = handlers_.begin();
-        auto size = handlers_.size();
-        for (size_t i = 0; i < size; ++i) {
-            // deleted flag might change during invocation
-            if (!it->second) {
-                it->first(std::forward<T>(args)...);
-            }
-            if (it->second) {
-                it = handlers_.erase(it);
-            } else {
-                ++it;
+        readers_.fetch_add(1);
+        if (auto const table = table_.load(); table != nullptr) {
+            for (auto& slot: *table) {
+                // removed flag might change during invocation
+                if (slot.removed.load(std::memory_order_acquire)) continue;
+                if (slot.target == nullptr) {
+                    slot.handler(args...);
+                } else {
+                    enqueue(slot, args...);
+                }
             }
         }
+        readers_.fetch_sub(1);
     }
 
+    [[nodiscard]] std::size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
 private:
-    std::pmr::list<std::pair<Handler, bool> > handlers_;
+    template<typename... T>
+    void enqueue(Slot const& slot, T const&... args)
+    {
+        for (auto& envelope: std::span{envelopes_.load(std::memory_order_acquire), envelopeCount}) {
+            if (envelope.used.exchange(true, std::memory_order_acquire)) continue;
+
+            envelope.event = this;
+            envelope.handler = slot.handler;
+            envelope.id = slot.id;
+            envelope.args = std::tuple<std::decay_t<Args>...>{args...};
+            if (!slot.target->post(fn<&Envelope::deliver>(envelope))) {
+                envelope.used.store(false, std::memory_order_release);
+                break;
+            }
+            return;
+        }
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool connected(std::uint32_t const id)
+    {
+        auto found = false;
+        readers_.fetch_add(1);
+        if (auto const table = table_.load(); table != nullptr) {
+            for (auto& slot: *table) {
+                if (slot.id == id && !slot.removed.load(std::memory_order_acquire)) found = true;
+            }
+        }
+        readers_.fetch_sub(1);
+        return found;
+    }
+
+    static void disconnect(void* event, std::uint32_t const id)
+    {
+        auto& self = *static_cast<SubscribeEvent*>(event);
+        std::lock_guard lock{self.mutex_};
+
+        // emissions in progress may still iterate the current or a retired table
+        auto const old = self.table_.load();
+        markRemoved(old, id);
+        for (auto table = self.retired_; table != nullptr; table = table->retired) {
+            markRemoved(table, id);
+        }
+        self.publish(self.copy(old, id, 0), old);
+    }
+
+    static void markRemoved(Table* table, std::uint32_t const id)
+    {
+        if (table == nullptr) return;
+        for (auto& slot: *table) {
+            if (slot.id == id) slot.removed.store(true, std::memory_order_release);
+        }
+    }
+
+    Table* copy(Table* source, std::uint32_t const removeId, std::size_t const extra)
+    {
+        auto const capacity = (source != nullptr ? source->size : 0) + extra;
+        if (capacity == 0) return nullptr;
+
+        auto const table = new(resource_->allocate(bytes(capacity), alignof(Table))) Table{capacity, 0, nullptr};
+        if (source != nullptr) {
+            for (auto& slot: *source) {
+                if (slot.id == removeId || slot.removed.load(std::memory_order_relaxed)) continue;
+                new(table->begin() + table->size++) Slot{slot.handler, slot.target, slot.id, false};
+            }
+        }
+        return table;
+    }
+
+    void publish(Table* table, Table* old)
+    {
+        table_.store(table);
+        if (old != nullptr) {
+            old->retired = retired_;
+            retired_ = old;
+        }
+        reclaim(false);
+    }
+
+    void reclaim(bool const force)
+    {
+        if (!force && readers_.load() != 0) return;
+        while (retired_ != nullptr) {
+            release(std::exchange(retired_, retired_->retired));
+        }
+    }
+
+    void release(Table* table)
+    {
+        if (table == nullptr) return;
+        std::destroy(table->begin(), table->end());
+        resource_->deallocate(table, bytes(table->capacity), alignof(Table));
+    }
+
+    static std::size_t bytes(std::size_t const capacity) { return sizeof(Table) + capacity * sizeof(Slot); }
+
+    std::atomic<Envelope*> envelopes_{};
+    std::atomic<std::size_t> dropped_{};
+    std::atomic<Table*> table_{};
+    std::atomic<std::uint32_t> readers_{};
+    Table* retired_{};
+    std::uint32_t nextId_{1};
+    std::mutex mutex_;
+    std::pmr::memory_resource* resource_{&events_object_pool};
 };
 
 #endif
@@ -1,45 +1,99 @@
 #ifndef AIVAS_IOT_FUNCTION_HPP
 #define AIVAS_IOT_FUNCTION_HPP
 
+#include <cassert>
 #include <cstddef>
 #include <algorithm>
 #include <array>
+#include <new>
+#include <type_traits>
+#include <utility>
 
-template<typename Signature>
+/**
+ * @brief Non-allocating callable wrapper.
+ *
+ * Holds a free function, an object/member function pair or any callable that fits into Capacity bytes of inline
+ * storage. Trivially copyable callables are copied bytewise, others through a manager function; wrappers holding a
+ * move-only callable must not be copied. Functions handed to ISRs must hold trivially copyable callables.
+ */
+template<typename Signature, std::size_t Capacity = sizeof(void*) * 3>
 class Function;
 
-template<typename Ret, typename... Args>
-class Function<Ret(Args...)>
+template<typename Ret, typename... Args, std::size_t Capacity>
+class Function<Ret(Args...), Capacity>
 {
     static constexpr std::size_t maxMemberPtrSize = sizeof(void*) * 2;
 
+    enum class Op { copy, move, destroy };
+
     using free_fn_type = Ret (*)(Args...);
-    using stub_fn_type = Ret (*)(void* free_or_mem_obj, void const* mem, Args&&... args);
+    using stub_fn_type = Ret (*)(void* storage, Args&&... args);
+    using manage_fn_type = void (*)(Op op, void* dst, void* src);
 
-    static Ret free_fn_stub(void* free_or_mem_obj, void const*, Args&&... args)
+    template<typename T, typename MemFn>
+    struct Bound
     {
-        return reinterpret_cast<Ret(*)(Args...)>(free_or_mem_obj)(std::forward<Args>(args)...);
+        T* object;
+        MemFn member;
+    };
+
+    template<typename F>
+    static constexpr bool fits = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t);
+
+    template<typename F>
+    static constexpr bool trivial = std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>;
+
+    static Ret free_fn_stub(void* storage, Args&&... args)
+    {
+        return (*static_cast<free_fn_type*>(storage))(std::forward<Args>(args)...);
     }
 
     template<typename T, typename MemFn>
-    static Ret mem_fn_stub(void* free_or_mem_obj, void const* mem, Args&&... args)
+    static Ret mem_fn_stub(void* storage, Args&&... args)
     {
-        auto pmf = *static_cast<MemFn const*>(mem);
-        return (static_cast<T*>(free_or_mem_obj)->*pmf)(std::forward<Args>(args)...);
+        auto const& bound = *static_cast<Bound<T, MemFn>*>(storage);
+        return (bound.object->*bound.member)(std::forward<Args>(args)...);
     }
 
-public:
-    Function() noexcept
-        : free_fn_or_mem_fn_obj{},
-          stub_fn{}
+    template<auto Member, typename T>
+    static Ret bound_fn_stub(void* storage, Args&&... args)
+    {
+        return ((*static_cast<T**>(storage))->*Member)(std::forward<Args>(args)...);
+    }
+
+    template<typename F>
+    static Ret callable_stub(void* storage, Args&&... args)
     {
+        return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
     }
 
+    template<typename F>
+    static void callable_manager(Op const op, void* dst, void* src)
+    {
+        switch (op) {
+            case Op::copy:
+                if constexpr (std::is_copy_constructible_v<F>) {
+                    new(dst) F(*static_cast<F const*>(src));
+                } else {
+                    assert(!"copy of a move-only callable");
+                }
+                break;
+            case Op::move:
+                new(dst) F(std::move(*static_cast<F*>(src)));
+                break;
+            case Op::destroy:
+                static_cast<F*>(dst)->~F();
+                break;
+        }
+    }
+
+public:
+    Function() noexcept = default;
+
     // ReSharper disable once CppNonExplicitConvertingConstructor
     Function(free_fn_type const function) noexcept // NOLINT(*-explicit-constructor)
-        : free_fn_or_mem_fn_obj{reinterpret_cast<void*>(function)},
-          stub_fn{&free_fn_stub}
     {
+        if (function != nullptr) emplace<free_fn_type>(&free_fn_stub, function);
     }
 
     template<typename F>
@@ -50,37 +104,133 @@ public:
     {
     }
 
+    template<typename F, typename Fn = std::remove_cvref_t<F>>
+    requires(!std::is_convertible_v<Fn, free_fn_type> && !std::is_same_v<Fn, Function>
+             && std::is_invocable_r_v<Ret, Fn&, Args...>)
+    // ReSharper disable once CppNonExplicitConvertingConstructor
+    Function(F&& function) // NOLINT(*-explicit-constructor)
+    {
+        static_assert(fits<Fn>, "callable too large for inline storage");
+        emplace<Fn>(&callable_stub<Fn>, std::forward<F>(function));
+        if constexpr (!trivial<Fn>) manage_fn = &callable_manager<Fn>;
+    }
+
     template<typename T>
     Function(T const& object, Ret (T::* member)(Args...) const) noexcept
-        : free_fn_or_mem_fn_obj{const_cast<T*>(&object)},
-          stub_fn{&mem_fn_stub<T const, Ret (T::*)(Args...) const>}
     {
+        using MemFn = decltype(member);
         static_assert(sizeof(member) <= maxMemberPtrSize, "member function pointer too large");
-        // ReSharper disable once CppDFANotInitializedField
-        std::copy_n(reinterpret_cast<std::byte*>(&member), sizeof(member), mem_fn.data());
+        emplace<Bound<T const, MemFn>>(&mem_fn_stub<T const, MemFn>, &object, member);
     }
 
     template<typename T>
     Function(T& object, Ret (T::* member)(Args...)) noexcept
-        : free_fn_or_mem_fn_obj{&object},
-          stub_fn{&mem_fn_stub<T, Ret (T::*)(Args...)>}
     {
+        using MemFn = decltype(member);
         static_assert(sizeof(member) <= maxMemberPtrSize, "member function pointer too large");
-        // ReSharper disable once CppDFANotInitializedField
-        std::copy_n(reinterpret_cast<std::byte*>(&member), sizeof(member), mem_fn.data());
+        emplace<Bound<T, MemFn>>(&mem_fn_stub<T, MemFn>, &object, member);
+    }
+
+    Function(Function const& other)
+        : stub_fn{other.stub_fn},
+          manage_fn{other.manage_fn}
+    {
+        if (manage_fn != nullptr) {
+            manage_fn(Op::copy, storage.data(), const_cast<std::byte*>(other.storage.data()));
+        } else {
+            storage = other.storage;
+        }
+    }
+
+    Function(Function&& other) noexcept
+        : stub_fn{other.stub_fn},
+          manage_fn{other.manage_fn}
+    {
+        if (manage_fn != nullptr) {
+            manage_fn(Op::move, storage.data(), other.storage.data());
+        } else {
+            storage = other.storage;
+        }
+    }
+
+    Function& operator=(Function const& other)
+    {
+        if (this != &other) {
+            this->~Function();
+            new(this) Function(other);
+        }
+        return *this;
+    }
+
+    Function& operator=(Function&& other) noexcept
+    {
+        if (this != &other) {
+            this->~Function();
+            new(this) Function(std::move(other));
+        }
+        return *this;
+    }
+
+    ~Function()
+    {
+        if (manage_fn != nullptr) manage_fn(Op::destroy, storage.data(), nullptr);
+    }
+
+    // binds a member function at compile time, the call goes straight to it without a stored member pointer
+    template<auto Member, typename T>
+    static Function bind(T& object) noexcept
+    {
+        Function function;
+        function.template emplace<T*>(&bound_fn_stub<Member, T>, &object);
+        return function;
     }
 
     Ret operator()(Args... args) const
     {
-        return stub_fn(free_fn_or_mem_fn_obj, mem_fn.data(), std::forward<decltype(args)>(args)...);
+        return stub_fn(const_cast<std::byte*>(storage.data()), std::forward<decltype(args)>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return stub_fn != nullptr; }
+
+    // compares the stored bytes, only meaningful for trivially copyable targets
+    bool operator==(Function const& other) const noexcept
+    {
+        return stub_fn == other.stub_fn && storage == other.storage;
     }
 
 private:
-    void* free_fn_or_mem_fn_obj;
-    alignas(std::max_align_t) std::array<std::byte, maxMemberPtrSize> mem_fn{};
-    stub_fn_type stub_fn;
+    template<typename F, typename... A>
+    void emplace(stub_fn_type const stub, A&&... args)
+    {
+        new(storage.data()) F{std::forward<A>(args)...};
+        stub_fn = stub;
+    }
+
+    alignas(std::max_align_t) std::array<std::byte, Capacity> storage{};
+    stub_fn_type stub_fn{};
+    manage_fn_type manage_fn{};
 };
 
+namespace detail
+{
+    template<typename MemFn>
+    struct MemberTraits;
+
+    template<typename T, typename Ret, typename... Args>
+    struct MemberTraits<Ret (T::*)(Args...)>
+    {
+        using Class = T;
+        using Signature = Ret(Args...);
+    };
+
+    template<typename T, typename Ret, typename... Args>
+    struct MemberTraits<Ret (T::*)(Args...) const>
+    {
+        using Class = T const;
+        using Signature = Ret(Args...);
+    };
+}
+
 /**
  * @brief Helpers to create a Function object from a member function pointer.
  */
@@ -97,4 +247,10 @@ auto fn(T const& object, Ret (T::*member)(Args...) const) noexcept
     return Function<Ret(Args...)>{object, member};
 }
 
-#endif
\ No newline at end of file
+template<auto Member>
+auto fn(typename detail::MemberTraits<decltype(Member)>::Class& object) noexcept
+{
+    return Function<typename detail::MemberTraits<decltype(Member)>::Signature>::template bind<Member>(object);
+}
+
+#endif
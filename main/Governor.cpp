@@ -0,0 +1,114 @@
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+
+#include "Application.hpp"
+#include "Governor.hpp"
+
+static constexpr auto TAG{"Governor"};
+
+struct Thresholds
+{
+    std::uint32_t caps;
+    std::size_t elevatedFree;
+    std::size_t elevatedBlock;
+    std::size_t criticalFree;
+    std::size_t criticalBlock;
+};
+
+static constexpr std::array<Thresholds, 2> heaps{{
+    {MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, 40 * 1024, 16 * 1024, 20 * 1024, 8 * 1024},
+    {MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, 512 * 1024, 128 * 1024, 256 * 1024, 64 * 1024},
+}};
+
+static constexpr auto samplePeriod = Duration::millis(1000);
+static constexpr std::size_t restoreAfterSamples = 10;
+
+MemoryGovernor::MemoryGovernor()
+    : sampleTimer_{"governor", fn<&MemoryGovernor::sample>(*this)}
+{
+    ESP_ERROR_CHECK(heap_caps_register_failed_alloc_callback(&MemoryGovernor::allocationFailed));
+    sampleTimer_.start(samplePeriod, true);
+}
+
+void MemoryGovernor::addFeature(char const* name, int const rank, Shedder const& shedder)
+{
+    assert(featureCount_ < maxFeatures);
+
+    // keep features ordered by rank, shed ones stay in front
+    auto pos = featureCount_;
+    while (pos > shedCount_ && features_[pos - 1].rank > rank) {
+        features_[pos] = features_[pos - 1];
+        --pos;
+    }
+    features_[pos] = {name, rank, shedder};
+    ++featureCount_;
+}
+
+char const* MemoryGovernor::pressureName(Pressure const pressure)
+{
+    switch (pressure) {
+        case Pressure::normal: return "normal";
+        case Pressure::elevated: return "elevated";
+        case Pressure::critical: return "critical";
+    }
+    return "?";
+}
+
+void MemoryGovernor::allocationFailed(std::size_t, std::uint32_t, char const*)
+{
+    // runs in the failing allocation's context, so only count and have the loop sample right away
+    auto& self = get();
+    self.failedAllocations_.fetch_add(1, std::memory_order_relaxed);
+    Application::get().post(fn<&MemoryGovernor::sample>(self));
+}
+
+void MemoryGovernor::sample()
+{
+    auto pressure = Pressure::normal;
+    for (auto const& heap: heaps) {
+        auto const free = heap_caps_get_free_size(heap.caps);
+        auto const block = heap_caps_get_largest_free_block(heap.caps);
+        if (free < heap.criticalFree || block < heap.criticalBlock) {
+            pressure = Pressure::critical;
+        } else if ((free < heap.elevatedFree || block < heap.elevatedBlock) && pressure == Pressure::normal) {
+            pressure = Pressure::elevated;
+        }
+    }
+
+    if (pressure != pressure_) {
+        ESP_LOGW(TAG, "memory pressure %s -> %s", pressureName(pressure_), pressureName(pressure));
+        pressure_ = pressure;
+        pressureEvent(pressure);
+    }
+
+    switch (pressure) {
+        case Pressure::critical:
+            while (shedCount_ < featureCount_) shedNext();
+            healthySamples_ = 0;
+            break;
+        case Pressure::elevated:
+            if (shedCount_ < featureCount_) shedNext();
+            healthySamples_ = 0;
+            break;
+        case Pressure::normal:
+            if (shedCount_ > 0 && ++healthySamples_ >= restoreAfterSamples) {
+                restoreLast();
+                healthySamples_ = 0;
+            }
+            break;
+    }
+}
+
+void MemoryGovernor::shedNext()
+{
+    auto const& feature = features_[shedCount_++];
+    ESP_LOGW(TAG, "shedding %s", feature.name);
+    feature.shedder(true);
+}
+
+void MemoryGovernor::restoreLast()
+{
+    auto const& feature = features_[--shedCount_];
+    ESP_LOGI(TAG, "restoring %s", feature.name);
+    feature.shedder(false);
+}
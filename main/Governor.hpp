@@ -0,0 +1,71 @@
+#ifndef AIVAS_IOT_GOVERNOR_HPP
+#define AIVAS_IOT_GOVERNOR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "Event.hpp"
+#include "Function.hpp"
+#include "Singleton.hpp"
+#include "Timer.hpp"
+
+/**
+ * @brief Watches free memory and the largest free block of the internal and PSRAM heaps and sheds optional
+ * features under pressure instead of running into failed allocations.
+ *
+ * Features are shed one per sample while pressure is elevated, all at once when critical, and restored one at a
+ * time in reverse order after the heaps stayed healthy for a while. Lower ranks are shed first.
+ */
+class MemoryGovernor : public Singleton<MemoryGovernor>
+{
+    static constexpr std::size_t maxFeatures = 8;
+
+public:
+    enum class Pressure : std::uint8_t { normal, elevated, critical };
+
+    // called with true when the feature has to release its memory, false when it may resume
+    using Shedder = Function<void(bool shed)>;
+
+    // shedding ranks of the optional features, lower ranks are shed first
+    static constexpr int historyRank = 0;
+    static constexpr int telemetryRank = 1;
+    static constexpr int animationRank = 2;
+
+    MemoryGovernor();
+    MemoryGovernor(MemoryGovernor const&) = delete;
+
+    [[nodiscard]] Pressure pressure() const { return pressure_; }
+    [[nodiscard]] std::uint32_t failedAllocations() const { return failedAllocations_.load(); }
+
+    // the feature has to outlive the governor
+    void addFeature(char const* name, int rank, Shedder const& shedder);
+
+    SubscribeEvent<void(Pressure)> pressureEvent;
+
+    static char const* pressureName(Pressure pressure);
+
+private:
+    struct Feature
+    {
+        char const* name;
+        int rank;
+        Shedder shedder;
+    };
+
+    static void allocationFailed(std::size_t size, std::uint32_t caps, char const* function);
+
+    void sample();
+    void shedNext();
+    void restoreLast();
+
+    std::array<Feature, maxFeatures> features_{};
+    std::size_t featureCount_{};
+    std::size_t shedCount_{};
+    std::size_t healthySamples_{};
+    Pressure pressure_{Pressure::normal};
+    std::atomic<std::uint32_t> failedAllocations_{};
+    Timer sampleTimer_;
+};
+
+#endif
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include "Application.hpp"
+#include "Governor.hpp"
+#include "History.hpp"
+#include "Mqtt.hpp"
+
+static constexpr auto TAG{"History"};
+
+// upper bounds of a formatted number plus its separator
+static constexpr std::size_t valueSize = 7;
+static constexpr std::size_t elapsedSize = 4;
+static constexpr std::size_t timeSize = 11;
+static constexpr std::size_t headerSize = 160;
+
+TimeSeries::TimeSeries(char const* name, Config const& config)
+    : name_{name},
+      config_{config},
+      raw_{&history_memory_resource},
+      minutes_{std::pmr::vector<Bucket>{&history_memory_resource}, 0, minuteCapacity},
+      minute_{.period = 60},
+      quarters_{std::pmr::vector<Bucket>{&history_memory_resource}, 0, quarterCapacity},
+      quarter_{.period = 15 * 60}
+{
+    shed(false);
+    MemoryGovernor::get().addFeature(name_, MemoryGovernor::historyRank, fn<&TimeSeries::shed>(*this));
+}
+
+bool TimeSeries::add(float const value)
+{
+    auto const now = esp_timer_get_time();
+    if (!shed_) record(static_cast<std::uint32_t>(now / 1'000'000), quantize(value));
+
+    auto const due = !everPublished_ || std::fabs(value - published_) >= config_.deadband
+                     || now - publishedAt_ >= static_cast<std::int64_t>(config_.heartbeat.millis()) * 1000;
+    if (due) {
+        published_ = value;
+        publishedAt_ = now;
+        everPublished_ = true;
+    }
+    return due;
+}
+
+std::size_t TimeSeries::batchSize(Resolution const resolution) const
+{
+    switch (resolution) {
+        case Resolution::raw: return headerSize + rawSize_ * (valueSize + elapsedSize);
+        case Resolution::minute: return headerSize + minutes_.buckets.size() * (timeSize + 3 * valueSize);
+        case Resolution::quarter: return headerSize + quarters_.buckets.size() * (timeSize + 3 * valueSize);
+    }
+    return headerSize;
+}
+
+void TimeSeries::write(detail::JsonWriter& writer, Resolution const resolution) const
+{
+    writer.raw("{\"series\":");
+    writer.value(name_);
+    writer.raw(",\"resolution\":");
+    writer.value(resolutionName(resolution));
+    writer.raw(",\"now\":");
+    writer.value(static_cast<std::uint32_t>(esp_timer_get_time() / 1'000'000));
+    writer.raw(",\"quantum\":");
+    writer.value(config_.quantum);
+
+    if (resolution != Resolution::raw) {
+        writeBuckets(writer, resolution == Resolution::minute ? minutes_ : quarters_);
+        writer.raw("}");
+        return;
+    }
+
+    // times as the first one plus the seconds elapsed in between
+    writer.raw(",\"t0\":");
+    writer.value(oldestAt_);
+    writer.raw(",\"dt\":[");
+    for (std::size_t i = 1; i < rawSize_; ++i) {
+        if (i > 1) writer.raw(",");
+        writer.value(raw_[(rawTail_ + i) % rawCapacity].elapsed);
+    }
+    writer.raw("],\"v\":[");
+    auto value = oldest_;
+    for (std::size_t i = 0; i < rawSize_; ++i) {
+        if (i > 0) {
+            writer.raw(",");
+            value += raw_[(rawTail_ + i) % rawCapacity].delta;
+        }
+        writer.value(value);
+    }
+    writer.raw("]}");
+}
+
+std::optional<TimeSeries::Resolution> TimeSeries::resolution(std::string_view const name)
+{
+    for (auto const resolution: {Resolution::raw, Resolution::minute, Resolution::quarter}) {
+        if (name == resolutionName(resolution)) return resolution;
+    }
+    return std::nullopt;
+}
+
+char const* TimeSeries::resolutionName(Resolution const resolution)
+{
+    switch (resolution) {
+        case Resolution::raw: return "raw";
+        case Resolution::minute: return "minute";
+        case Resolution::quarter: return "quarter";
+    }
+    return "?";
+}
+
+void TimeSeries::BucketRing::push(Bucket const& bucket)
+{
+    if (buckets.size() < capacity) {
+        buckets.push_back(bucket);
+    } else {
+        buckets[head] = bucket;
+        head = (head + 1) % capacity;
+    }
+}
+
+void TimeSeries::Accumulator::add(std::uint32_t const now, std::int16_t const value, BucketRing& ring)
+{
+    auto const bucketStart = now - now % period;
+    if (count > 0 && bucketStart != start) {
+        ring.push({start, min, max, static_cast<std::int16_t>(sum / static_cast<std::int32_t>(count))});
+        count = 0;
+    }
+    if (count == 0) {
+        start = bucketStart;
+        min = value;
+        max = value;
+        sum = 0;
+    }
+    min = std::min(min, value);
+    max = std::max(max, value);
+    sum += value;
+    ++count;
+}
+
+void TimeSeries::record(std::uint32_t const now, std::int16_t const value)
+{
+    minute_.add(now, value, minutes_);
+    quarter_.add(now, value, quarters_);
+
+    if (rawSize_ == 0) {
+        oldest_ = newest_ = value;
+        oldestAt_ = newestAt_ = now;
+        raw_[rawTail_] = {};
+        rawSize_ = 1;
+        return;
+    }
+
+    if (rawSize_ == rawCapacity) {
+        rawTail_ = (rawTail_ + 1) % rawCapacity;
+        oldest_ += raw_[rawTail_].delta;
+        oldestAt_ += raw_[rawTail_].elapsed;
+        --rawSize_;
+    }
+
+    // steps larger than a delta are spread over the following samples, since they relate to newest_
+    auto const delta = static_cast<std::int8_t>(std::clamp<std::int32_t>(value - newest_, INT8_MIN, INT8_MAX));
+    auto const elapsed = static_cast<std::uint8_t>(std::min<std::uint32_t>(now - newestAt_, UINT8_MAX));
+    raw_[(rawTail_ + rawSize_) % rawCapacity] = {delta, elapsed};
+    ++rawSize_;
+    newest_ += delta;
+    newestAt_ += elapsed;
+}
+
+void TimeSeries::shed(bool const shed)
+{
+    shed_ = shed;
+
+    rawTail_ = 0;
+    rawSize_ = 0;
+    minutes_.buckets.clear();
+    minutes_.head = 0;
+    minute_.count = 0;
+    quarters_.buckets.clear();
+    quarters_.head = 0;
+    quarter_.count = 0;
+
+    if (shed) {
+        raw_.clear();
+        raw_.shrink_to_fit();
+        minutes_.buckets.shrink_to_fit();
+        quarters_.buckets.shrink_to_fit();
+    } else {
+        raw_.resize(rawCapacity);
+        minutes_.buckets.reserve(minuteCapacity);
+        quarters_.buckets.reserve(quarterCapacity);
+    }
+}
+
+std::int16_t TimeSeries::quantize(float const value) const
+{
+    auto const quanta = std::lround(value / config_.quantum);
+    return static_cast<std::int16_t>(std::clamp<long>(quanta, INT16_MIN, INT16_MAX));
+}
+
+void TimeSeries::writeBuckets(detail::JsonWriter& writer, BucketRing const& ring) const
+{
+    auto const size = ring.buckets.size();
+    auto const column = [&](char const* name, auto const member) {
+        writer.raw(",\"");
+        writer.raw(name);
+        writer.raw("\":[");
+        for (std::size_t i = 0; i < size; ++i) {
+            if (i > 0) writer.raw(",");
+            writer.value(ring.buckets[(ring.head + i) % size].*member);
+        }
+        writer.raw("]");
+    };
+    column("t", &Bucket::start);
+    column("min", &Bucket::min);
+    column("max", &Bucket::max);
+    column("avg", &Bucket::avg);
+}
+
+History::History()
+    : topic_{Mqtt::get().topics().add("tele", "HISTORY")}
+{
+    auto& mqtt = Mqtt::get();
+    mqtt.subscribe(mqtt.topics()[mqtt.topics().add("cmnd", "HISTORY")], fn<&History::query>(*this), 64);
+}
+
+void History::track(TimeSeries& series)
+{
+    assert(seriesCount_ < maxSeries);
+    series_[seriesCount_++] = &series;
+}
+
+void History::query(std::string_view const payload)
+{
+    auto const separator = payload.find(' ');
+    auto const name = payload.substr(0, separator);
+    auto const resolution = TimeSeries::resolution(
+        separator == std::string_view::npos ? "raw" : payload.substr(separator + 1));
+
+    auto const end = series_.begin() + seriesCount_;
+    auto const series = std::find_if(series_.begin(), end, [&](auto const candidate) {
+        return name == candidate->name();
+    });
+    if (series == end || !resolution) {
+        ESP_LOGW(TAG, "invalid history query: %.*s", payload.length(), payload.data());
+        return;
+    }
+
+    Application::get().post([this, series = *series, resolution = *resolution] { publish(*series, resolution); });
+}
+
+void History::publish(TimeSeries const& series, TimeSeries::Resolution const resolution) const
+{
+    String payload{&json_memory_resource};
+    payload.resize(series.batchSize(resolution));
+    detail::JsonWriter writer{payload};
+    series.write(writer, resolution);
+
+    if (auto const result = writer.result(); result.empty()) {
+        ESP_LOGE(TAG, "history batch of %s exceeded %u bytes", series.name(), payload.size());
+    } else if (!Mqtt::get().publish(topic_, result, false, 0)) {
+        ESP_LOGW(TAG, "history batch of %s not sent", series.name());
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef AIVAS_IOT_HISTORY_HPP
+#define AIVAS_IOT_HISTORY_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "JsonMessage.hpp"
+#include "Singleton.hpp"
+#include "Time.hpp"
+#include "TopicRegistry.hpp"
+
+/**
+ * @brief History of one sensor value at three resolutions: raw samples, 1 minute and 15 minute buckets.
+ *
+ * Values are stored as multiples of the configured quantum, raw samples as 8 bit deltas to their predecessor,
+ * buckets as min/max/avg. add() also decides whether a sample is worth publishing: when it left the deadband
+ * around the last published value or the heartbeat interval passed. The rings live in PSRAM and are released
+ * while the MemoryGovernor sheds history. Must be used from the Application loop.
+ */
+class TimeSeries
+{
+    static constexpr std::size_t rawCapacity = 600;     // 10 minutes at 1 sample/s
+    static constexpr std::size_t minuteCapacity = 360;  // 6 hours
+    static constexpr std::size_t quarterCapacity = 384; // 4 days
+
+public:
+    enum class Resolution : std::uint8_t { raw, minute, quarter };
+
+    struct Config
+    {
+        float quantum;      // resolution of the stored values
+        float deadband;     // published when the value moved at least this far
+        Duration heartbeat; // published at least this often
+    };
+
+    TimeSeries(char const* name, Config const& config);
+    TimeSeries(TimeSeries const&) = delete;
+
+    [[nodiscard]] char const* name() const { return name_; }
+
+    // returns true if the value should be published
+    bool add(float value);
+
+    // upper bound of the JSON written for the resolution
+    [[nodiscard]] std::size_t batchSize(Resolution resolution) const;
+    void write(detail::JsonWriter& writer, Resolution resolution) const;
+
+    static std::optional<Resolution> resolution(std::string_view name);
+    static char const* resolutionName(Resolution resolution);
+
+private:
+    struct Sample
+    {
+        std::int8_t delta;    // to the previous sample, in quanta
+        std::uint8_t elapsed; // since the previous sample, in s
+    };
+
+    struct Bucket
+    {
+        std::uint32_t start; // uptime in s
+        std::int16_t min;
+        std::int16_t max;
+        std::int16_t avg;
+    };
+
+    // fills up to its capacity, then overwrites the oldest bucket at head
+    struct BucketRing
+    {
+        std::pmr::vector<Bucket> buckets;
+        std::size_t head;
+        std::size_t capacity;
+
+        void push(Bucket const& bucket);
+    };
+
+    struct Accumulator
+    {
+        std::uint32_t period; // in s
+        std::uint32_t start{};
+        std::int16_t min{};
+        std::int16_t max{};
+        std::int32_t sum{};
+        std::uint32_t count{};
+
+        // closes the current bucket into ring once now is in a later period
+        void add(std::uint32_t now, std::int16_t value, BucketRing& ring);
+    };
+
+    void record(std::uint32_t now, std::int16_t value);
+    void shed(bool shed);
+
+    [[nodiscard]] std::int16_t quantize(float value) const;
+
+    void writeBuckets(detail::JsonWriter& writer, BucketRing const& ring) const;
+
+    char const* name_;
+    Config config_;
+    bool shed_{};
+
+    // raw ring, the delta of the oldest sample is meaningless, its value and time are kept in oldest_/oldestAt_
+    std::pmr::vector<Sample> raw_;
+    std::size_t rawTail_{};
+    std::size_t rawSize_{};
+    std::int32_t oldest_{};
+    std::int32_t newest_{};
+    std::uint32_t oldestAt_{};
+    std::uint32_t newestAt_{};
+
+    BucketRing minutes_;
+    Accumulator minute_;
+    BucketRing quarters_;
+    Accumulator quarter_;
+
+    float published_{};
+    std::int64_t publishedAt_{};
+    bool everPublished_{};
+};
+
+/**
+ * @brief Answers history queries on cmnd/<base>/HISTORY with one batch on tele/<base>/HISTORY.
+ *
+ * The payload is "<series> [raw|minute|quarter]", e.g. "temperature minute". Values are sent as integer multiples
+ * of the series' quantum, times as uptime in seconds.
+ */
+class History : public Singleton<History>
+{
+    static constexpr std::size_t maxSeries = 4;
+
+public:
+    History();
+    History(History const&) = delete;
+
+    // the series has to outlive the history
+    void track(TimeSeries& series);
+
+private:
+    // called on the MQTT task, the batch is built on the Application loop
+    void query(std::string_view payload);
+    void publish(TimeSeries const& series, TimeSeries::Resolution resolution) const;
+
+    TopicRegistry::Id const topic_;
+    std::array<TimeSeries*, maxSeries> series_{};
+    std::size_t seriesCount_{};
+};
+
+#endif
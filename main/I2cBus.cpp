@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cassert>
+
+#include <esp_log.h>
+
+#include "Application.hpp"
+#include "I2cBus.hpp"
+
+static constexpr auto TAG{"I2cBus"};
+
+I2cBus::I2cBus(gpio_num_t const sda, gpio_num_t const scl, std::uint32_t const clockHz)
+    : clockHz_{clockHz}
+{
+    i2c_config_t const config = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = sda,
+        .scl_io_num = scl,
+        .sda_pullup_en = GPIO_PULLUP_DISABLE,
+        .scl_pullup_en = GPIO_PULLUP_DISABLE,
+        .master{
+            .clk_speed = clockHz
+        },
+        .clk_flags = 0
+    };
+    handle_ = i2c_bus_create(I2C_NUM_0, &config);
+    assert(handle_ != nullptr);
+
+    for (auto& request: requests_) {
+        request.bus = this;
+    }
+    task_.emplace("i2c", fn<&I2cBus::run>(*this), StackDepth{3072}, Priority{4});
+    ESP_LOGI(TAG, "bus running at %lu Hz", clockHz_);
+}
+
+I2cBus::~I2cBus()
+{
+    running_ = false;
+    mailbox_.post([] {});
+    task_.reset();
+
+    for (auto& device: std::span{devices_}.first(deviceCount_)) {
+        if (auto const error = i2c_bus_device_delete(&device); error != ESP_OK) {
+            ESP_LOGW(TAG, "device not deleted: %s", esp_err_to_name(error));
+        }
+    }
+    // fails while drivers that were handed handle() still hold devices on the bus
+    if (auto const error = i2c_bus_delete(&handle_); error != ESP_OK) {
+        ESP_LOGW(TAG, "bus not deleted: %s", esp_err_to_name(error));
+    }
+}
+
+I2cBus::Device I2cBus::addDevice(std::uint8_t const address)
+{
+    assert(deviceCount_ < maxDevices);
+    auto const device = i2c_bus_device_create(handle_, address, 0);
+    assert(device != nullptr);
+    devices_[deviceCount_++] = device;
+    return device;
+}
+
+bool I2cBus::submit(Device const device, std::span<std::uint8_t const> const write, std::size_t const readSize,
+                    Completion const& completion)
+{
+    assert(write.size() <= maxWriteSize && readSize <= maxReadSize);
+
+    auto const request = std::ranges::find_if(requests_, [](Request& candidate) {
+        return !candidate.used.exchange(true, std::memory_order_acquire);
+    });
+    if (request == requests_.end()) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    request->device = device;
+    request->writeSize = std::ranges::copy(write, request->write.begin()).out - request->write.begin();
+    request->readSize = readSize;
+    request->error = ESP_OK;
+    request->completion = completion;
+    if (!mailbox_.post(fn<&Request::execute>(*request))) {
+        request->completion = {};
+        request->used.store(false, std::memory_order_release);
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+I2cBus::Stats I2cBus::stats() const
+{
+    return {
+        executed_.load(std::memory_order_relaxed),
+        failed_.load(std::memory_order_relaxed),
+        rejected_.load(std::memory_order_relaxed),
+    };
+}
+
+void I2cBus::Request::execute()
+{
+    {
+        PowerLockGuard guard{bus->lock_};
+        if (writeSize > 0) error = i2c_bus_write_bytes(device, NULL_I2C_MEM_ADDR, writeSize, write.data());
+        if (error == ESP_OK && readSize > 0) {
+            error = i2c_bus_read_bytes(device, NULL_I2C_MEM_ADDR, readSize, data.data());
+        }
+    }
+
+    bus->executed_.fetch_add(1, std::memory_order_relaxed);
+    if (error != ESP_OK) bus->failed_.fetch_add(1, std::memory_order_relaxed);
+
+    // blocks while the loop's queue is full, the I2C task has nothing else to do anyway
+    Application::get().dispatch(fn<&Request::complete>(*this));
+}
+
+void I2cBus::Request::complete()
+{
+    // the slot is released first, so the completion may submit the next transaction right away
+    auto const completion = std::move(this->completion);
+    auto const result = data;
+    auto const size = error == ESP_OK ? readSize : 0;
+    auto const status = error;
+    used.store(false, std::memory_order_release);
+
+    if (status != ESP_OK) ESP_LOGW(TAG, "transaction failed: %s", esp_err_to_name(status));
+    if (completion) completion(status, std::span{result}.first(size));
+}
+
+void I2cBus::run()
+{
+    while (running_) {
+        mailbox_.process(Duration::max());
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef AIVAS_IOT_I2CBUS_HPP
+#define AIVAS_IOT_I2CBUS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include <driver/gpio.h>
+#include <i2c_bus.h>
+
+#include "Delivery.hpp"
+#include "Function.hpp"
+#include "Power.hpp"
+#include "Task.hpp"
+
+/**
+ * @brief I2C master bus whose transactions are executed on a dedicated task.
+ *
+ * Each transaction writes a few command bytes and/or reads a short response from one device, the completion is
+ * dispatched to the Application loop. Slow devices split "trigger" and "read result" into two transactions, so the
+ * bus is free while they convert.
+ */
+class I2cBus
+{
+    static constexpr std::size_t requestCount = 8;
+    static constexpr std::size_t maxWriteSize = 4;
+    static constexpr std::size_t maxReadSize = 8;
+    static constexpr std::size_t maxDevices = 4;
+
+public:
+    using Device = i2c_bus_device_handle_t;
+    using Completion = Function<void(esp_err_t error, std::span<std::uint8_t const> data)>;
+
+    static constexpr std::uint32_t standardMode = 100'000;
+    static constexpr std::uint32_t fastMode = 400'000;
+
+    struct Stats
+    {
+        std::uint32_t executed;
+        std::uint32_t failed;
+        std::uint32_t rejected;
+    };
+
+    I2cBus(gpio_num_t sda, gpio_num_t scl, std::uint32_t clockHz = standardMode);
+    I2cBus(I2cBus const&) = delete;
+    ~I2cBus();
+
+    // for drivers that talk to their device during initialization only, never use it once transactions are queued
+    [[nodiscard]] i2c_bus_handle_t handle() const { return handle_; }
+    [[nodiscard]] std::uint32_t clock() const { return clockHz_; }
+
+    // the device is deleted with the bus
+    [[nodiscard]] Device addDevice(std::uint8_t address);
+
+    // writes write, then reads readSize bytes; returns false if all requests are in flight
+    bool submit(Device device, std::span<std::uint8_t const> write, std::size_t readSize,
+                Completion const& completion);
+
+    [[nodiscard]] Stats stats() const;
+
+private:
+    struct Request
+    {
+        I2cBus* bus{};
+        Device device{};
+        std::array<std::uint8_t, maxWriteSize> write{};
+        std::size_t writeSize{};
+        std::array<std::uint8_t, maxReadSize> data{};
+        std::size_t readSize{};
+        esp_err_t error{};
+        Completion completion;
+        std::atomic<bool> used{};
+
+        void execute();
+        void complete();
+    };
+
+    void run();
+
+    i2c_bus_handle_t handle_;
+    std::uint32_t clockHz_;
+    PowerLock lock_{"i2cBus", ESP_PM_APB_FREQ_MAX};
+    std::array<Device, maxDevices> devices_{};
+    std::size_t deviceCount_{};
+    std::array<Request, requestCount> requests_;
+    Mailbox mailbox_;
+    std::atomic<std::uint32_t> executed_{};
+    std::atomic<std::uint32_t> failed_{};
+    std::atomic<std::uint32_t> rejected_{};
+    bool volatile running_{true};
+    std::optional<Task> task_;
+};
+
+#endif
@@ -33,6 +33,6 @@ ARDUINOJSON_END_PUBLIC_NAMESPACE
 
 ArduinoJson::JsonDocument jsonDocument()
 {
-    static detail::ResourceAllocator allocator{&psram_memory_resource};
+    static detail::ResourceAllocator allocator{&json_memory_resource};
     return ArduinoJson::JsonDocument{&allocator};
 }
@@ -0,0 +1,45 @@
+#include "JsonMessage.hpp"
+
+void detail::JsonWriter::raw(std::string_view const str)
+{
+    if (static_cast<std::size_t>(end_ - pos_) < str.size()) {
+        overflow_ = true;
+        return;
+    }
+    pos_ = std::copy(str.begin(), str.end(), pos_);
+}
+
+void detail::JsonWriter::value(std::string_view const str)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+
+    put('"');
+    for (auto const c: str) {
+        switch (c) {
+            case '"': raw("\\\""); break;
+            case '\\': raw("\\\\"); break;
+            case '\n': raw("\\n"); break;
+            case '\r': raw("\\r"); break;
+            case '\t': raw("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    raw("\\u00");
+                    put(hex[c >> 4]);
+                    put(hex[c & 0xf]);
+                } else {
+                    put(c);
+                }
+                break;
+        }
+    }
+    put('"');
+}
+
+void detail::JsonWriter::put(char const c)
+{
+    if (pos_ == end_) {
+        overflow_ = true;
+        return;
+    }
+    *pos_++ = c;
+}
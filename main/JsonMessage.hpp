@@ -0,0 +1,114 @@
+#ifndef AIVAS_IOT_JSONMESSAGE_HPP
+#define AIVAS_IOT_JSONMESSAGE_HPP
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace detail {
+    template<std::size_t N>
+    struct FixedString
+    {
+        char value[N]{};
+
+        // ReSharper disable once CppNonExplicitConvertingConstructor
+        constexpr FixedString(char const (&str)[N]) // NOLINT(*-explicit-constructor)
+        {
+            std::copy_n(str, N, value);
+        }
+
+        [[nodiscard]] constexpr std::size_t size() const { return N - 1; }
+    };
+
+    // ,"name": with the separator included, the first field skips it
+    template<FixedString Name>
+    constexpr auto jsonKey = [] {
+        static_assert(std::none_of(Name.value, Name.value + Name.size(), [](char c) { return c == '"' || c == '\\'; }),
+                      "field names must not need escaping");
+        std::array<char, Name.size() + 4> key{};
+        key[0] = ',';
+        key[1] = '"';
+        std::copy_n(Name.value, Name.size(), key.begin() + 2);
+        key[Name.size() + 2] = '"';
+        key[Name.size() + 3] = ':';
+        return key;
+    }();
+
+    class JsonWriter
+    {
+    public:
+        explicit JsonWriter(std::span<char> const buffer)
+            : begin_{buffer.data()},
+              pos_{buffer.data()},
+              end_{buffer.data() + buffer.size()}
+        {
+        }
+
+        void raw(std::string_view str);
+        void value(std::string_view str);
+        void value(char const* str) { value(std::string_view{str}); }
+        void value(bool boolean) { raw(boolean ? "true" : "false"); }
+
+        template<typename T>
+        requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+        void value(T const number)
+        {
+            auto const [ptr, ec] = std::to_chars(pos_, end_, number);
+            if (ec != std::errc{}) {
+                overflow_ = true;
+                return;
+            }
+            pos_ = ptr;
+        }
+
+        // empty if the buffer was too small
+        [[nodiscard]] std::string_view result() const
+        {
+            return overflow_ ? std::string_view{} : std::string_view{begin_, static_cast<std::size_t>(pos_ - begin_)};
+        }
+
+    private:
+        void put(char c);
+
+        char* begin_;
+        char* pos_;
+        char* end_;
+        bool overflow_{};
+    };
+}
+
+/**
+ * @brief Serializer for flat JSON objects whose field names are known at compile time.
+ *
+ * Writes into a caller-provided buffer without allocating, keys are precomputed and numbers are formatted with
+ * to_chars. Values are passed in the order of the names.
+ */
+template<detail::FixedString... Names>
+struct JsonMessage
+{
+    template<typename... Values>
+    requires(sizeof...(Values) == sizeof...(Names))
+    static std::string_view write(std::span<char> const buffer, Values const&... values)
+    {
+        detail::JsonWriter writer{buffer};
+        writer.raw("{");
+        auto first = true;
+        ((writeField(writer, detail::jsonKey<Names>, first), writer.value(values)), ...);
+        writer.raw("}");
+        return writer.result();
+    }
+
+private:
+    template<std::size_t N>
+    static void writeField(detail::JsonWriter& writer, std::array<char, N> const& key, bool& first)
+    {
+        writer.raw(std::string_view{key.data() + (first ? 1 : 0), first ? N - 1 : N});
+        first = false;
+    }
+};
+
+#endif
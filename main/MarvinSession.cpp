@@ -2,26 +2,14 @@
 
 #include "Application.hpp"
 #include "AudioSession.hpp"
-#include "Json.hpp"
+#include "JsonMessage.hpp"
 #include "MarvinSession.hpp"
 #include "WebSocket.hpp"
 
 static constexpr auto TAG{"MarvinSession"};
 
-static bool waitUntil(auto pred, Duration const timeout)
-{
-    constexpr auto delayMs = 1;
-
-    auto const start = pdTICKS_TO_MS(xTaskGetTickCount());
-    while (!pred()) {
-        if (pdTICKS_TO_MS(xTaskGetTickCount()) - start >= timeout.millis()) return false;
-        vTaskDelay(pdMS_TO_TICKS(delayMs));
-    }
-    return true;
-}
-
 MarvinSession::MarvinSession()
-    : afeDetected_{AudioSession::get().detectEvent.connect({*this, &MarvinSession::afeDetected})},
+    : afeDetected_{AudioSession::get().detectEvent.connect({*this, &MarvinSession::afeDetected}, loopDelivery)},
       afeSpeech_{AudioSession::get().speechEvent.connect({*this, &MarvinSession::afeSpeech})},
       afeSilence_{AudioSession::get().silenceEvent.connect({*this, &MarvinSession::afeSilence})}
 {
@@ -30,82 +18,111 @@ MarvinSession::MarvinSession()
 void MarvinSession::afeDetected()
 {
     running_ = true;
-    streamTask_.emplace("marvinStream", fn(*this, &MarvinSession::streamTask), StackDepth{8192}, Priority{5}, Core{0});
+    if (active_) {
+        ESP_LOGW(TAG, "marvin stream still active, ignoring wakeword");
+        return;
+    }
+    stream();
 }
 
 void MarvinSession::afeSpeech()
 {
     AudioSession::get().audioBuffer().drop_except_last(2);
-    streaming_.store(true, std::memory_order_release);
+    streaming_.set();
 }
 
 void MarvinSession::afeSilence()
 {
-    streaming_.store(false, std::memory_order_release);
+    streaming_.reset();
 }
 
-void MarvinSession::streamTask()
+void MarvinSession::wsConnected()
+{
+    connected_.set();
+}
+
+void MarvinSession::wsDisconnected()
+{
+    connected_.reset();
+}
+
+Coroutine MarvinSession::stream()
 {
     constexpr auto connectTimeout = Duration::millis(10'000);
     constexpr auto streamingTimeout = Duration::millis(500);
     constexpr auto flushWaitDelay = Duration::millis(500);
 
-    std::unique_ptr<std::optional<Task>, void(*)(void*)> scopeGuard{
-        &streamTask_, [](auto ptr) {
-            ESP_LOGI(TAG, "dispatching deletion of marvin stream task to main loop");
-            Application::get().dispatch({*static_cast<std::optional<Task>*>(ptr), &std::optional<Task>::reset});
-        }
-    };
+    std::unique_ptr<bool, void(*)(bool*)> activeGuard{&active_, [](auto active) { *active = false; }};
+    active_ = true;
+    connected_.reset();
+
+    // the session-scoped allocations below (the WebSocket URI) come from the arena, reset in one go when the
+    // utterance ends
+    auto const arenaScope = arena_.scope();
 
-    WebSocket webSocket{"192.168.176.220", 9090, "/realtime"};
-    if (!waitUntil([&webSocket] { return webSocket.connected(); }, connectTimeout)) {
+    std::optional<PowerLockGuard> networkGuard{networkLock_};
+    WebSocket webSocket{
+        "192.168.176.220", 9090, "/realtime",
+        fn(*this, &MarvinSession::wsConnected), fn(*this, &MarvinSession::wsDisconnected), &arena_
+    };
+    if (!co_await connected_.wait(connectTimeout)) {
         ESP_LOGE(TAG, "could not connect to WebSocket within %lu ms", connectTimeout.millis());
-        return;
+        co_return;
     }
-    if (!waitUntil([this] { return streaming_.load(std::memory_order_acquire); }, streamingTimeout)) {
+    networkGuard.reset();
+
+    if (!co_await streaming_.wait(streamingTimeout)) {
         ESP_LOGE(TAG, "no start signal from afe session within %lu ms", streamingTimeout.millis());
-        return;
+        co_return;
     }
 
+    // sends block for up to sendTimeout, they run on the worker pool while the coroutine is suspended
+    auto& executor = Application::get().executor();
+    PowerLockGuard streamGuard{streamLock_};
     {
-        auto startMsg = jsonDocument();
-        startMsg["type"] = "start";
-        startMsg["deviceId"] = Application::get().clientId();
-        startMsg["fmt"] = "pcm16_le";
-        startMsg["sampleRate"] = 16000;
-        startMsg["frameSamples"] = 320;
-        startMsg["channels"] = 1;
-        startMsg["endian"] = "le";
-        startMsg["gain"] = 1.0;
-        webSocket.sendText(str(startMsg));
+        using StartMessage = JsonMessage<
+            "type", "deviceId", "fmt", "sampleRate", "frameSamples", "channels", "endian", "gain"
+        >;
+        std::array<char, 192> buffer;
+        auto const message = StartMessage::write(
+            buffer, "start", Application::get().clientId(), "pcm16_le", 16000, 320, 1, "le", 1.0
+        );
+        // the client id is not bounded
+        if (message.empty()) {
+            ESP_LOGE(TAG, "start message exceeded %u bytes", buffer.size());
+            co_return;
+        }
+        if (!co_await executor.offload([&webSocket, &message] { webSocket.sendText(message, sendTimeout); })) {
+            ESP_LOGE(TAG, "worker pool rejected the start message");
+            co_return;
+        }
     }
 
     auto& audioBuffer = AudioSession::get().audioBuffer();
+    auto const drain = [this, &webSocket] {
+        auto& audioBuffer = AudioSession::get().audioBuffer();
+        auto const send = [&webSocket, frameBytes = audioBuffer.frameSize() * sizeof(int16_t)](auto ptr) {
+            webSocket.sendBinary({reinterpret_cast<uint8_t const*>(ptr), frameBytes}, sendTimeout);
+        };
+        while (running_ && audioBuffer.pop_nowait(send)) {}
+    };
+
     while (running_) {
-        if (!streaming_.load(std::memory_order_acquire)) {
-            auto endMsg = jsonDocument();
-            endMsg["type"] = "stop";
-            webSocket.sendText(str(endMsg));
-            vTaskDelay(flushWaitDelay.ticks());
+        if (!streaming_.signaled()) {
+            std::array<char, 16> buffer;
+            auto const message = JsonMessage<"type">::write(buffer, "stop");
+            co_await executor.offload([&webSocket, &message] { webSocket.sendText(message, sendTimeout); });
+            co_await executor.sleep(flushWaitDelay);
             break;
         }
 
-        struct Visitor
-        {
-            WebSocket& webSocket;
-            std::size_t frameSize;
-
-            void operator()(std::int16_t const* ptr) const
-            {
-                webSocket.sendBinary({reinterpret_cast<uint8_t const*>(ptr), frameSize * sizeof(int16_t) });
-            }
-        };
-
-        Visitor visitor{webSocket, audioBuffer.frameSize()};
-        bool anySent{};
-        while (running_ && audioBuffer.pop_nowait({visitor, &Visitor::operator()})) {
-            anySent = true;
+        // frames pushed while draining set the event again, so none can be missed
+        audioBuffer.dataEvent().reset();
+        if (!co_await executor.offload(drain)) {
+            ESP_LOGW(TAG, "worker pool busy, retrying");
+            co_await executor.sleep(Duration::millis(10));
+            continue;
         }
-        if (!anySent) vTaskDelay(1);
+        co_await audioBuffer.dataEvent().wait(streamingTimeout);
     }
 }
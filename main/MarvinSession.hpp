@@ -1,30 +1,40 @@
 #ifndef AIVAS_IOT_MARVINSESSION_HPP
 #define AIVAS_IOT_MARVINSESSION_HPP
 
-#include <optional>
-
+#include "Arena.hpp"
+#include "Coroutine.hpp"
 #include "Event.hpp"
-#include "Task.hpp"
+#include "Power.hpp"
 
 class MarvinSession
 {
+    static constexpr auto sendTimeout = Duration::millis(100);
+
 public:
     MarvinSession();
     MarvinSession(MarvinSession const&) = delete;
 
 private:
-    void streamTask();
+    Coroutine stream();
 
-    void afeDetected();
+    void afeDetected(); // delivered on the Application loop
+    // called on the AudioSession detect task
     void afeSpeech();
     void afeSilence();
 
+    void wsConnected();
+    void wsDisconnected();
+
     Subscription afeDetected_;
     Subscription afeSpeech_;
     Subscription afeSilence_;
-    std::optional<Task> streamTask_;
+    SessionArena arena_{"marvin", 256, network_memory_resource}; // the WebSocket URI plus headroom
+    PowerLock streamLock_{"marvinStream", ESP_PM_CPU_FREQ_MAX};
+    PowerLock networkLock_{"marvinNetwork", ESP_PM_APB_FREQ_MAX};
+    AsyncEvent connected_;
+    AsyncEvent streaming_;
+    bool active_{};
     bool volatile running_{};
-    std::atomic<bool> streaming_{false};
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -2,3 +2,78 @@
 
 idf_psram_memory_resource psram_memory_resource;
 idf_internal_memory_resource internal_memory_resource;
+
+tagged_memory_resource audio_memory_resource{"audio", psram_memory_resource};
+tagged_memory_resource audio_internal_memory_resource{"audio/int", internal_memory_resource};
+tagged_memory_resource network_memory_resource{"network", psram_memory_resource};
+tagged_memory_resource json_memory_resource{"json", psram_memory_resource};
+tagged_memory_resource events_memory_resource{"events", psram_memory_resource};
+tagged_memory_resource history_memory_resource{"history", psram_memory_resource};
+
+std::array<tagged_memory_resource const*, 6> const memory_tags{
+    &audio_memory_resource,
+    &audio_internal_memory_resource,
+    &network_memory_resource,
+    &json_memory_resource,
+    &events_memory_resource,
+    &history_memory_resource,
+};
+
+tagged_memory_resource::tagged_memory_resource(char const* name, idf_memory_resource_base& upstream) noexcept
+    : name_{name},
+      upstream_{upstream}
+{
+}
+
+tagged_memory_resource::stats tagged_memory_resource::get_stats() const
+{
+    return {
+        live_bytes_.load(std::memory_order_relaxed),
+        peak_bytes_.load(std::memory_order_relaxed),
+        alloc_count_.load(std::memory_order_relaxed),
+        heap_caps_get_largest_free_block(caps()),
+    };
+}
+
+void* tagged_memory_resource::reallocate(void* ptr, std::size_t const new_size)
+{
+    auto const old_size = ptr != nullptr ? heap_caps_get_allocated_size(ptr) : 0;
+    auto const result = upstream_.reallocate(ptr, new_size);
+    if (result == nullptr) return nullptr;
+
+    account_deallocated(old_size);
+    account_allocated(heap_caps_get_allocated_size(result));
+    return result;
+}
+
+void* tagged_memory_resource::do_allocate(std::size_t const size, std::size_t const alignment)
+{
+    auto const ptr = upstream_.allocate(size, alignment);
+    account_allocated(heap_caps_get_allocated_size(ptr));
+    return ptr;
+}
+
+void tagged_memory_resource::do_deallocate(void* ptr, std::size_t const size, std::size_t const alignment)
+{
+    account_deallocated(heap_caps_get_allocated_size(ptr));
+    upstream_.deallocate(ptr, size, alignment);
+}
+
+bool tagged_memory_resource::do_is_equal(const memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void tagged_memory_resource::account_allocated(std::size_t const size)
+{
+    alloc_count_.fetch_add(1, std::memory_order_relaxed);
+    auto const live = live_bytes_.fetch_add(size, std::memory_order_relaxed) + size;
+    for (auto peak = peak_bytes_.load(std::memory_order_relaxed); live > peak;) {
+        if (peak_bytes_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) break;
+    }
+}
+
+void tagged_memory_resource::account_deallocated(std::size_t const size)
+{
+    live_bytes_.fetch_sub(size, std::memory_order_relaxed);
+}
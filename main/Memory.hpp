@@ -1,6 +1,7 @@
 #ifndef AIVAS_IOT_MEMORY_HPP
 #define AIVAS_IOT_MEMORY_HPP
 
+#include <array>
 #include <atomic>
 #include <memory_resource>
 
@@ -9,23 +10,39 @@
 struct idf_memory_resource_base : std::pmr::memory_resource
 {
     virtual void* reallocate(void* ptr, std::size_t new_size) = 0;
+    [[nodiscard]] virtual uint32_t caps() const = 0;
 };
 
-template<uint32_t Caps>
+// falls back to the heap given by FallbackCaps before giving up
+template<uint32_t Caps, uint32_t FallbackCaps = 0>
 struct idf_memory_resource final : idf_memory_resource_base
 {
     std::atomic<std::size_t> alloc_count;
     std::atomic<std::size_t> free_count;
+    std::atomic<std::size_t> fallback_count;
 
     void* reallocate(void* ptr, std::size_t const new_size) override
     {
-        return heap_caps_realloc(ptr, new_size, Caps | MALLOC_CAP_8BIT);
+        if (auto const result = heap_caps_realloc(ptr, new_size, Caps | MALLOC_CAP_8BIT); result != nullptr) {
+            return result;
+        }
+        if constexpr (FallbackCaps != 0) {
+            ++fallback_count;
+            return heap_caps_realloc(ptr, new_size, FallbackCaps | MALLOC_CAP_8BIT);
+        }
+        return nullptr;
     }
 
+    [[nodiscard]] uint32_t caps() const override { return Caps | MALLOC_CAP_8BIT; }
+
     void* do_allocate(std::size_t const size, std::size_t) override
     {
         alloc_count += size;
         if (auto const ptr = heap_caps_malloc(size, Caps | MALLOC_CAP_8BIT); ptr != nullptr) return ptr;
+        if constexpr (FallbackCaps != 0) {
+            ++fallback_count;
+            if (auto const ptr = heap_caps_malloc(size, FallbackCaps | MALLOC_CAP_8BIT); ptr != nullptr) return ptr;
+        }
         throw std::bad_alloc{};
     }
 
@@ -41,12 +58,63 @@ struct idf_memory_resource final : idf_memory_resource_base
     }
 };
 
-using idf_psram_memory_resource = idf_memory_resource<MALLOC_CAP_SPIRAM>;
-using idf_internal_memory_resource = idf_memory_resource<MALLOC_CAP_INTERNAL>;
+using idf_psram_memory_resource = idf_memory_resource<MALLOC_CAP_SPIRAM, MALLOC_CAP_INTERNAL>;
+using idf_internal_memory_resource = idf_memory_resource<MALLOC_CAP_INTERNAL, MALLOC_CAP_SPIRAM>;
+
+/**
+ * @brief Accounts the allocations of one subsystem on top of an idf heap resource.
+ *
+ * Sizes are taken from the heap itself, so callers passing no or wrong sizes on deallocation (ArduinoJson) are
+ * accounted correctly.
+ */
+class tagged_memory_resource final : public idf_memory_resource_base
+{
+public:
+    struct stats
+    {
+        std::size_t live_bytes;
+        std::size_t peak_bytes;
+        std::size_t alloc_count;
+        std::size_t largest_free_block; // of the upstream heap, sampled when the stats are taken
+    };
+
+    tagged_memory_resource(char const* name, idf_memory_resource_base& upstream) noexcept;
+    tagged_memory_resource(tagged_memory_resource const&) = delete;
+
+    [[nodiscard]] char const* name() const { return name_; }
+    [[nodiscard]] stats get_stats() const;
+
+    // for resources that are not served by the upstream heap but belong to the tag, sizes as requested
+    void account_allocated(std::size_t size);
+    void account_deallocated(std::size_t size);
+
+    void* reallocate(void* ptr, std::size_t new_size) override;
+    [[nodiscard]] uint32_t caps() const override { return upstream_.caps(); }
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override;
+
+    char const* name_;
+    idf_memory_resource_base& upstream_;
+    std::atomic<std::size_t> live_bytes_{};
+    std::atomic<std::size_t> peak_bytes_{};
+    std::atomic<std::size_t> alloc_count_{};
+};
 
 extern idf_psram_memory_resource psram_memory_resource;
 extern idf_internal_memory_resource internal_memory_resource;
 
+extern tagged_memory_resource audio_memory_resource;
+extern tagged_memory_resource audio_internal_memory_resource;
+extern tagged_memory_resource network_memory_resource;
+extern tagged_memory_resource json_memory_resource;
+extern tagged_memory_resource events_memory_resource;
+extern tagged_memory_resource history_memory_resource;
+
+extern std::array<tagged_memory_resource const*, 6> const memory_tags;
+
 extern std::pmr::polymorphic_allocator<> psram_allocator;
 extern std::pmr::polymorphic_allocator<> internal_allocator;
 
@@ -0,0 +1,98 @@
+#ifndef AIVAS_IOT_MPSCQUEUE_HPP
+#define AIVAS_IOT_MPSCQUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer queue for handing items out of ISRs.
+ *
+ * Producers claim cells by CAS and publish them with a per-cell sequence number. Producers must not be preemptible
+ * by the consumer (i.e. ISRs), because the consumer waits for a claimed cell to be published. Copying T runs inside
+ * the producer, so it must neither block nor allocate.
+ */
+template<typename T, std::size_t Capacity>
+class MpscQueue
+{
+    static_assert(std::is_default_constructible_v<T> && std::is_copy_assignable_v<T>);
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+public:
+    enum class Pushed : std::uint8_t
+    {
+        overflow, // queue full, item discarded
+        appended, // queue was non-empty, consumer is already due
+        first     // queue was empty, consumer has to be woken
+    };
+
+    MpscQueue() noexcept
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(MpscQueue const&) = delete;
+
+    [[nodiscard]] static constexpr std::size_t capacity() { return Capacity; }
+    [[nodiscard]] std::size_t size() const { return size_.load(std::memory_order_acquire); }
+    [[nodiscard]] std::size_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+
+    Pushed push(T const& item)
+    {
+        auto pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & (Capacity - 1)];
+            auto const sequence = cell->sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+                return Pushed::overflow;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return size_.fetch_add(1, std::memory_order_acq_rel) == 0 ? Pushed::first : Pushed::appended;
+    }
+
+    bool pop(T& item)
+    {
+        if (size_.load(std::memory_order_acquire) == 0) return false;
+
+        // a published item implies all earlier cells are claimed, their producers finish within microseconds
+        auto& cell = cells_[dequeuePos_ & (Capacity - 1)];
+        while (cell.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {}
+
+        item = std::move(cell.value);
+        cell.value = T{};
+        cell.sequence.store(dequeuePos_ + Capacity, std::memory_order_release);
+        ++dequeuePos_;
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+private:
+    std::array<Cell, Capacity> cells_;
+    std::atomic<std::size_t> enqueuePos_{0};
+    std::size_t dequeuePos_{0};
+    std::atomic<std::size_t> size_{0};
+    std::atomic<std::size_t> overflows_{0};
+};
+
+#endif
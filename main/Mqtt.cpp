@@ -16,9 +16,9 @@ static String toBaseTopic(std::string_view clientId)
 }
 
 Mqtt::Mqtt(std::string_view host, uint16_t const port)
-    : uri_{str("mqtt://", host, ":", port)},
-      baseTopic_{toBaseTopic(Application::get().clientId())},
-      willTopic_{str("tele/", baseTopic_, "/LWT")},
+    : uri_{str<uriCapacity>("mqtt://", host, ":", port)},
+      topics_{toBaseTopic(Application::get().clientId()), &network_memory_resource},
+      willTopic_{topics_.add("tele", "LWT")},
       wiFiConnected_{WiFi::get().connectEvent.connect({*this, &Mqtt::connectToMqtt})},
       wiFiDisconnected_{WiFi::get().disconnectEvent.connect({*this, &Mqtt::wiFiDisconnected})}
 {
@@ -26,7 +26,7 @@ Mqtt::Mqtt(std::string_view host, uint16_t const port)
     esp_mqtt_client_config_t config = {};
     config.broker.address.uri = uri_.c_str();
     config.credentials.client_id = copyOfClientId.c_str();
-    config.session.last_will.topic = willTopic_.c_str();
+    config.session.last_will.topic = topics_[willTopic_].c_str();
     config.session.last_will.msg = "Offline";
     config.session.last_will.retain = 1;
 
@@ -47,22 +47,32 @@ Mqtt::~Mqtt()
     esp_mqtt_client_destroy(handle_);
 }
 
-void Mqtt::publish(String const& topic, std::string_view const payload, bool const retain) const
+bool Mqtt::publish(String const& topic, std::string_view const payload, bool const retain, int const qos) const
 {
-    publish(topic.c_str(), payload, retain);
+    return publish(topic.c_str(), payload, retain, qos);
 }
 
-void Mqtt::publish(char const* topic, std::string_view const payload, bool const retain) const
+bool Mqtt::publish(TopicRegistry::Id const topic, std::string_view const payload, bool const retain,
+                   int const qos) const
 {
-    if (!connected_) return;
-    esp_mqtt_client_publish(handle_, topic, payload.data(), static_cast<int>(payload.size()), 1, retain);
+    return publish(topics_[topic].c_str(), payload, retain, qos);
 }
 
-void Mqtt::subscribe(String topic, Subscriber handler)
+bool Mqtt::publish(char const* topic, std::string_view const payload, bool const retain, int const qos) const
 {
-    if (auto const it = subscriptions_.emplace(std::move(topic), handler);
-        connected_ && subscriptions_.count(it->first) == 1) {
-        mqttSubscribe(it->first);
+    if (!connected_) return false;
+    return esp_mqtt_client_publish(handle_, topic, payload.data(), static_cast<int>(payload.size()), qos, retain) >= 0;
+}
+
+void Mqtt::subscribe(std::string_view const topic, Subscriber const& handler, std::size_t const maxPayload)
+{
+    if (!TopicTrie<Handler>::valid(topic)) {
+        ESP_LOGE(TAG, "invalid topic filter: %.*s", topic.length(), topic.data());
+        return;
+    }
+    // false for a duplicate, which just adds a handler to the existing subscription
+    if (subscriptions_.insert(topic, {handler, maxPayload}) && connected_) {
+        mqttSubscribe(subscriptions_.filters().back());
     }
 }
 
@@ -78,10 +88,7 @@ void Mqtt::mqttClientEventHandler(void* arg, esp_event_base_t, int32_t const eve
             self.mqttDisconnected();
             break;
         case MQTT_EVENT_DATA:
-            self.mqttMessage(
-                {data->topic, static_cast<std::size_t>(data->topic_len)},
-                {data->data, static_cast<std::size_t>(data->data_len)}
-            );
+            self.mqttData(*data);
             break;
         default:
             break;
@@ -111,9 +118,10 @@ void Mqtt::mqttConnected()
 
     connected_ = true;
     publish(willTopic_, "Online", true);
-    for (auto it = subscriptions_.cbegin(); it != subscriptions_.cend(); it = subscriptions_.upper_bound(it->first)) {
-        mqttSubscribe(it->first);
+    for (auto const& filter: subscriptions_.filters()) {
+        mqttSubscribe(filter);
     }
+    connectEvent();
 }
 
 void Mqtt::mqttDisconnected()
@@ -122,12 +130,62 @@ void Mqtt::mqttDisconnected()
     connected_ = false;
 }
 
-void Mqtt::mqttMessage(std::string_view const topic, std::string_view const payload)
+void Mqtt::mqttData(esp_mqtt_event_t const& data)
 {
-    ESP_LOGI(TAG, "received '%.*s' at topic %.*s", payload.length(), payload.data(), topic.length(), topic.data());
+    auto const total = static_cast<std::size_t>(data.total_data_len);
+    auto const offset = static_cast<std::size_t>(data.current_data_offset);
+    std::string_view const chunk{data.data, static_cast<std::size_t>(data.data_len)};
+
+    // complete messages are passed on without copying
+    if (offset == 0 && chunk.size() == total) {
+        mqttMessage({data.topic, static_cast<std::size_t>(data.topic_len)}, chunk);
+        return;
+    }
 
-    auto [begin, end] = subscriptions_.equal_range(topic);
-    std::for_each(begin, end, [&](auto const& pair) { pair.second(payload); });
+    // only the first fragment carries the topic
+    if (offset == 0) {
+        if (fragmentSize_ != 0) ++stats_.abandoned;
+        fragmentTopic_.assign(data.topic, data.topic_len);
+        fragmentSize_ = 0;
+
+        std::size_t maxPayload{};
+        auto const subscribers = subscriptions_.match(fragmentTopic_, [&](Handler const& handler) {
+            maxPayload = std::max(maxPayload, handler.maxPayload);
+        });
+        if (total > maxPayload) {
+            ESP_LOGW(TAG, "dropping %u byte message at topic %s", total, fragmentTopic_.c_str());
+            stats_.oversizeDrops += subscribers;
+            return;
+        }
+        fragments_.resize(total);
+        fragmentSize_ = total;
+    }
+
+    // fragments of a dropped message or out of order ones are ignored
+    if (fragmentSize_ != total || offset + chunk.size() > total) return;
+    std::ranges::copy(chunk, fragments_.begin() + static_cast<std::ptrdiff_t>(offset));
+    if (offset + chunk.size() < total) return;
+
+    ++stats_.reassembled;
+    fragmentSize_ = 0;
+    mqttMessage(fragmentTopic_, {fragments_.data(), total});
+    if (fragments_.capacity() > retainedBufferSize) {
+        fragments_.clear();
+        fragments_.shrink_to_fit();
+    }
+}
+
+void Mqtt::mqttMessage(std::string_view const topic, std::string_view const payload)
+{
+    ESP_LOGI(TAG, "received %u bytes at topic %.*s", payload.length(), topic.length(), topic.data());
+
+    subscriptions_.match(topic, [&](Handler const& handler) {
+        if (payload.size() <= handler.maxPayload) {
+            handler.subscriber(payload);
+        } else {
+            ++stats_.oversizeDrops;
+        }
+    });
 }
 
 void Mqtt::mqttSubscribe(String const& topic) const
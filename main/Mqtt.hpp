@@ -1,33 +1,64 @@
 #ifndef AIVAS_IOT_MQTT_HPP
 #define AIVAS_IOT_MQTT_HPP
 
-#include <functional>
-#include <map>
+#include <cstdint>
 #include <string_view>
+#include <vector>
 
 #include <mqtt_client.h>
 
 #include "Event.hpp"
 #include "Function.hpp"
+#include "Pool.hpp"
 #include "Singleton.hpp"
 #include "String.hpp"
+#include "TopicRegistry.hpp"
+#include "TopicTrie.hpp"
 
 class Mqtt : public Singleton<Mqtt>
 {
     using Subscriber = Function<void(std::string_view payload)>;
 
+    struct Handler
+    {
+        Subscriber subscriber;
+        std::size_t maxPayload;
+    };
+
+    // fragment buffers up to this size are kept for the next fragmented message
+    static constexpr std::size_t retainedBufferSize = 4096;
+    static constexpr std::size_t uriCapacity = 63;
+
 public:
+    static constexpr std::size_t defaultMaxPayload = 4096;
+
+    struct Stats
+    {
+        std::uint32_t reassembled;
+        std::uint32_t oversizeDrops; // per subscriber
+        std::uint32_t abandoned;
+    };
+
     explicit Mqtt(std::string_view host, uint16_t port = 1883);
     Mqtt(Mqtt const&) = delete;
     ~Mqtt();
 
-    [[nodiscard]] String const& baseTopic() const { return baseTopic_; }
+    [[nodiscard]] std::string_view baseTopic() const { return topics_.baseTopic(); }
+    [[nodiscard]] TopicRegistry& topics() { return topics_; }
 
     [[nodiscard]] bool connected() const { return connected_; }
 
-    void publish(String const& topic, std::string_view payload, bool retain = false) const;
-    void publish(char const* topic, std::string_view payload, bool retain = false) const;
-    void subscribe(String topic, Subscriber handler);
+    // returns false if the message could not be handed to the client
+    bool publish(String const& topic, std::string_view payload, bool retain = false, int qos = 1) const;
+    bool publish(char const* topic, std::string_view payload, bool retain = false, int qos = 1) const;
+    bool publish(TopicRegistry::Id topic, std::string_view payload, bool retain = false, int qos = 1) const;
+    // topic may contain + and # wildcards, every filter is subscribed at the broker once; larger messages are dropped
+    void subscribe(std::string_view topic, Subscriber const& handler, std::size_t maxPayload = defaultMaxPayload);
+
+    [[nodiscard]] Stats stats() const { return stats_; }
+
+    // emitted on the MQTT task
+    SubscribeEvent<void()> connectEvent;
 
 private:
     static void mqttClientEventHandler(void* arg, esp_event_base_t, int32_t event_id, void* event_data);
@@ -36,18 +67,23 @@ private:
     void wiFiDisconnected();
     void mqttConnected();
     void mqttDisconnected();
+    void mqttData(esp_mqtt_event_t const& data);
     void mqttMessage(std::string_view topic, std::string_view payload);
     void mqttSubscribe(String const& topic) const;
 
-    String const uri_;
-    String const baseTopic_;
-    String const willTopic_;
+    StaticString<uriCapacity> const uri_;
+    TopicRegistry topics_;
+    TopicRegistry::Id const willTopic_;
     Subscription wiFiConnected_;
     Subscription wiFiDisconnected_;
     esp_mqtt_client_handle_t handle_{};
     bool started_{};
     bool connected_{};
-    std::pmr::multimap<String, Subscriber, std::less<>> subscriptions_;
+    TopicTrie<Handler> subscriptions_{&network_object_pool};
+    String fragmentTopic_{&network_memory_resource};
+    std::pmr::vector<char> fragments_{&network_memory_resource};
+    std::size_t fragmentSize_{};
+    Stats stats_{};
 };
 
 #endif
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+
+#include "Pool.hpp"
+
+SizeClassPool small_object_pool{{{16, 64}, {32, 64}, {64, 48}, {128, 32}, {256, 16}}, psram_memory_resource};
+TaggedPool events_object_pool{small_object_pool, events_memory_resource};
+TaggedPool network_object_pool{small_object_pool, network_memory_resource};
+
+SizeClassPool::SizeClassPool(std::initializer_list<Class> const classes, std::pmr::memory_resource& fallback)
+    : fallback_{fallback}
+{
+    assert(classes.size() <= maxClasses);
+
+    // every class starts on a regionAlignment boundary, so its blocks are aligned to min(blockSize, regionAlignment)
+    auto const padded = [](std::size_t const bytes) { return (bytes + regionAlignment - 1) & ~(regionAlignment - 1); };
+
+    std::size_t bytes{};
+    for (auto const& [blockSize, blockCount]: classes) {
+        assert((blockSize & (blockSize - 1)) == 0 && blockCount < none);
+        bytes += padded(blockSize * blockCount) + blockCount * sizeof(std::atomic<std::uint16_t>);
+    }
+
+    region_ = static_cast<std::byte*>(
+        heap_caps_aligned_alloc(regionAlignment, bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+    );
+    configASSERT(region_ != nullptr);
+
+    // blocks first, so a pointer belongs to the pool iff it lies in [region_, regionEnd_)
+    auto blocks = region_;
+    for (auto const& [blockSize, blockCount]: classes) {
+        auto& sizeClass = classes_[classCount_++];
+        sizeClass.blockSize = blockSize;
+        sizeClass.blockCount = blockCount;
+        sizeClass.blocks = blocks;
+        blocks += padded(blockSize * blockCount);
+    }
+    regionEnd_ = blocks;
+
+    auto next = reinterpret_cast<std::atomic<std::uint16_t>*>(blocks);
+    for (std::size_t i = 0; i < classCount_; ++i) {
+        auto& sizeClass = classes_[i];
+        sizeClass.next = next;
+        for (std::size_t block = 0; block < sizeClass.blockCount; ++block) {
+            new(&next[block]) std::atomic<std::uint16_t>(block + 1 < sizeClass.blockCount ? block + 1 : none);
+        }
+        sizeClass.head.store(sizeClass.blockCount > 0 ? 0 : none);
+        next += sizeClass.blockCount;
+    }
+}
+
+SizeClassPool::~SizeClassPool()
+{
+    heap_caps_free(region_);
+}
+
+SizeClassPool::Stats SizeClassPool::stats(std::size_t const index) const
+{
+    auto const& sizeClass = classes_[index];
+    return {
+        sizeClass.blockSize,
+        sizeClass.blockCount,
+        sizeClass.inUse.load(std::memory_order_relaxed),
+        sizeClass.highWater.load(std::memory_order_relaxed),
+        sizeClass.allocations.load(std::memory_order_relaxed),
+        sizeClass.fallbacks.load(std::memory_order_relaxed),
+    };
+}
+
+void* SizeClassPool::do_allocate(std::size_t const size, std::size_t const alignment)
+{
+    for (std::size_t i = 0; i < classCount_; ++i) {
+        auto& sizeClass = classes_[i];
+        if (size > sizeClass.blockSize) continue;
+        if (alignment > std::min(sizeClass.blockSize, regionAlignment)) break;
+
+        sizeClass.allocations.fetch_add(1, std::memory_order_relaxed);
+        if (auto const ptr = pop(sizeClass); ptr != nullptr) {
+            auto const inUse = sizeClass.inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+            for (auto highWater = sizeClass.highWater.load(std::memory_order_relaxed); inUse > highWater;) {
+                if (sizeClass.highWater.compare_exchange_weak(highWater, inUse, std::memory_order_relaxed)) break;
+            }
+            return ptr;
+        }
+        sizeClass.fallbacks.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+    return fallback_.allocate(size, alignment);
+}
+
+void SizeClassPool::do_deallocate(void* ptr, std::size_t const size, std::size_t const alignment)
+{
+    auto const bytes = static_cast<std::byte*>(ptr);
+    if (bytes < region_ || bytes >= regionEnd_) {
+        fallback_.deallocate(ptr, size, alignment);
+        return;
+    }
+
+    for (std::size_t i = 0; i < classCount_; ++i) {
+        auto& sizeClass = classes_[i];
+        if (bytes < sizeClass.blocks + sizeClass.blockSize * sizeClass.blockCount) {
+            sizeClass.inUse.fetch_sub(1, std::memory_order_relaxed);
+            push(sizeClass, ptr);
+            return;
+        }
+    }
+}
+
+bool SizeClassPool::do_is_equal(memory_resource const& other) const noexcept
+{
+    return this == &other;
+}
+
+void* SizeClassPool::pop(SizeClass& sizeClass)
+{
+    auto head = sizeClass.head.load(std::memory_order_acquire);
+    while (true) {
+        auto const index = static_cast<std::uint16_t>(head & 0xffff);
+        if (index == none) return nullptr;
+
+        // next may be stale if the block was taken meanwhile, the tag makes the exchange fail in that case
+        auto const next = sizeClass.next[index].load(std::memory_order_relaxed);
+        auto const tag = (head >> 16) + 1;
+        if (sizeClass.head.compare_exchange_weak(head, tag << 16 | next, std::memory_order_acquire)) {
+            return sizeClass.blocks + index * sizeClass.blockSize;
+        }
+    }
+}
+
+void SizeClassPool::push(SizeClass& sizeClass, void* ptr)
+{
+    auto const index = static_cast<std::uint16_t>(
+        (static_cast<std::byte*>(ptr) - sizeClass.blocks) / static_cast<std::ptrdiff_t>(sizeClass.blockSize)
+    );
+    auto head = sizeClass.head.load(std::memory_order_relaxed);
+    while (true) {
+        sizeClass.next[index].store(static_cast<std::uint16_t>(head & 0xffff), std::memory_order_relaxed);
+        auto const tag = (head >> 16) + 1;
+        if (sizeClass.head.compare_exchange_weak(head, tag << 16 | index, std::memory_order_release)) return;
+    }
+}
+
+TaggedPool::TaggedPool(SizeClassPool& pool, tagged_memory_resource& tag) noexcept
+    : pool_{pool},
+      tag_{tag}
+{
+}
+
+void* TaggedPool::do_allocate(std::size_t const size, std::size_t const alignment)
+{
+    auto const ptr = pool_.allocate(size, alignment);
+    tag_.account_allocated(size);
+    return ptr;
+}
+
+void TaggedPool::do_deallocate(void* ptr, std::size_t const size, std::size_t const alignment)
+{
+    tag_.account_deallocated(size);
+    pool_.deallocate(ptr, size, alignment);
+}
+
+bool TaggedPool::do_is_equal(memory_resource const& other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,107 @@
+#ifndef AIVAS_IOT_POOL_HPP
+#define AIVAS_IOT_POOL_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
+
+#include "Memory.hpp"
+
+/**
+ * @brief Size-class pool resource carved from internal SRAM for small, frequently allocated objects.
+ *
+ * Every class keeps its free blocks on a lock-free stack with a tagged head against ABA. Blocks are aligned to their
+ * size up to alignof(max_align_t). Requests that are too large, over-aligned or hit an exhausted class go to the
+ * fallback resource.
+ */
+class SizeClassPool final : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t maxClasses = 8;
+
+    struct Class
+    {
+        std::size_t blockSize; // power of two
+        std::size_t blockCount;
+    };
+
+    struct Stats
+    {
+        std::size_t blockSize;
+        std::size_t blockCount;
+        std::size_t inUse;
+        std::size_t highWater;
+        std::uint32_t allocations;
+        std::uint32_t fallbacks;
+    };
+
+    SizeClassPool(std::initializer_list<Class> classes, std::pmr::memory_resource& fallback);
+    SizeClassPool(SizeClassPool const&) = delete;
+    ~SizeClassPool() override;
+
+    [[nodiscard]] std::size_t classCount() const { return classCount_; }
+    [[nodiscard]] Stats stats(std::size_t index) const;
+
+private:
+    static constexpr std::uint16_t none = 0xffff;
+    static constexpr std::size_t regionAlignment = alignof(std::max_align_t);
+
+    struct SizeClass
+    {
+        std::size_t blockSize{};
+        std::size_t blockCount{};
+        std::byte* blocks{};
+        std::atomic<std::uint16_t>* next{};
+        std::atomic<std::uint32_t> head{}; // modification tag << 16 | index of the first free block
+        std::atomic<std::size_t> inUse{};
+        std::atomic<std::size_t> highWater{};
+        std::atomic<std::uint32_t> allocations{};
+        std::atomic<std::uint32_t> fallbacks{};
+    };
+
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(memory_resource const& other) const noexcept override;
+
+    static void* pop(SizeClass& sizeClass);
+    static void push(SizeClass& sizeClass, void* ptr);
+
+    std::array<SizeClass, maxClasses> classes_{};
+    std::size_t classCount_{};
+    std::byte* region_{};
+    std::byte* regionEnd_{};
+    std::pmr::memory_resource& fallback_;
+};
+
+/**
+ * @brief Allocates from a shared SizeClassPool and accounts the allocations to a memory tag.
+ *
+ * Accounts the requested sizes, pooled blocks and fallbacks alike, so callers have to pass the allocated size on
+ * deallocation like the pmr containers do.
+ */
+class TaggedPool final : public std::pmr::memory_resource
+{
+public:
+    TaggedPool(SizeClassPool& pool, tagged_memory_resource& tag) noexcept;
+    TaggedPool(TaggedPool const&) = delete;
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(memory_resource const& other) const noexcept override;
+
+    SizeClassPool& pool_;
+    tagged_memory_resource& tag_;
+};
+
+// small object pool in internal SRAM, falling back to PSRAM
+extern SizeClassPool small_object_pool;
+
+// views of small_object_pool for the events and network tags
+extern TaggedPool events_object_pool;
+extern TaggedPool network_object_pool;
+
+#endif
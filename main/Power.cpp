@@ -0,0 +1,109 @@
+#include <cstdio>
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#include "Power.hpp"
+
+static constexpr auto TAG{"Power"};
+
+static portMUX_TYPE registryLock = portMUX_INITIALIZER_UNLOCKED;
+static PowerLock* registry{};
+
+static char const* typeName(esp_pm_lock_type_t const type)
+{
+    switch (type) {
+        case ESP_PM_CPU_FREQ_MAX: return "cpu";
+        case ESP_PM_APB_FREQ_MAX: return "apb";
+        case ESP_PM_NO_LIGHT_SLEEP: return "nosleep";
+        default: return "?";
+    }
+}
+
+PowerLock::PowerLock(char const* name, esp_pm_lock_type_t const type)
+    : name_{name}
+{
+    // without CONFIG_PM_ENABLE the lock API reports ESP_ERR_NOT_SUPPORTED, locks become statistics only
+    if (auto const err = esp_pm_lock_create(type, 0, name_, &handle_); err != ESP_OK) {
+        ESP_LOGW(TAG, "could not create %s lock %s: %s", typeName(type), name_, esp_err_to_name(err));
+        handle_ = nullptr;
+    }
+
+    taskENTER_CRITICAL(&registryLock);
+    next_ = registry;
+    registry = this;
+    taskEXIT_CRITICAL(&registryLock);
+}
+
+PowerLock::~PowerLock()
+{
+    taskENTER_CRITICAL(&registryLock);
+    for (auto it = &registry; *it != nullptr; it = &(*it)->next_) {
+        if (*it == this) {
+            *it = next_;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&registryLock);
+
+    if (handle_ != nullptr) esp_pm_lock_delete(handle_);
+}
+
+void PowerLock::acquire()
+{
+    if (handle_ != nullptr) esp_pm_lock_acquire(handle_);
+    acquiredAt_ = esp_timer_get_time();
+}
+
+void PowerLock::release()
+{
+    auto const held = static_cast<std::uint32_t>(esp_timer_get_time() - acquiredAt_);
+    if (handle_ != nullptr) esp_pm_lock_release(handle_);
+
+    acquired_.fetch_add(1, std::memory_order_relaxed);
+    totalHeldUs_.fetch_add(held, std::memory_order_relaxed);
+    if (held > maxHeldUs_.load(std::memory_order_relaxed)) {
+        maxHeldUs_.store(held, std::memory_order_relaxed);
+    }
+}
+
+PowerLock::Stats PowerLock::stats() const
+{
+    return {
+        acquired_.load(std::memory_order_relaxed),
+        totalHeldUs_.load(std::memory_order_relaxed),
+        maxHeldUs_.load(std::memory_order_relaxed),
+    };
+}
+
+void PowerLock::configure(int const maxFreqMhz, int const minFreqMhz)
+{
+    esp_pm_config_t const config{
+        .max_freq_mhz = maxFreqMhz,
+        .min_freq_mhz = minFreqMhz,
+        .light_sleep_enable = false
+    };
+    if (auto const err = esp_pm_configure(&config); err != ESP_OK) {
+        ESP_LOGW(TAG, "dynamic frequency scaling not available: %s", esp_err_to_name(err));
+        return;
+    }
+    ESP_LOGI(TAG, "dynamic frequency scaling enabled between %d and %d MHz", minFreqMhz, maxFreqMhz);
+}
+
+void PowerLock::printUsage()
+{
+    auto const uptimeUs = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&registryLock);
+    auto const first = registry;
+    taskEXIT_CRITICAL(&registryLock);
+
+    // locks are owned by long-lived singletons, so the list is walked without holding the spinlock
+    for (auto lock = first; lock != nullptr; lock = lock->next_) {
+        auto const [acquired, totalHeldUs, maxHeldUs] = lock->stats();
+        printf("pm lock %-14s acquired %8lu, held %6.2f%%, max %6lu us\n", lock->name_,
+               static_cast<unsigned long>(acquired), 100.0 * static_cast<double>(totalHeldUs) / uptimeUs,
+               static_cast<unsigned long>(maxHeldUs));
+    }
+}
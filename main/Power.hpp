@@ -0,0 +1,68 @@
+#ifndef AIVAS_IOT_POWER_HPP
+#define AIVAS_IOT_POWER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include <esp_pm.h>
+
+/**
+ * @brief Named esp_pm lock that keeps track of how long and how often it was held.
+ *
+ * Acquire/release must be balanced per lock instance, nesting is not supported.
+ */
+class PowerLock
+{
+public:
+    struct Stats
+    {
+        std::uint32_t acquired;
+        std::uint64_t totalHeldUs;
+        std::uint32_t maxHeldUs;
+    };
+
+    PowerLock(char const* name, esp_pm_lock_type_t type);
+    PowerLock(PowerLock const&) = delete;
+    ~PowerLock();
+
+    [[nodiscard]] char const* name() const { return name_; }
+
+    void acquire();
+    void release();
+
+    [[nodiscard]] Stats stats() const;
+
+    static void configure(int maxFreqMhz, int minFreqMhz);
+    static void printUsage();
+
+private:
+    char const* name_;
+    esp_pm_lock_handle_t handle_{};
+    std::int64_t acquiredAt_{};
+    std::atomic<std::uint32_t> acquired_{};
+    std::atomic<std::uint64_t> totalHeldUs_{};
+    std::atomic<std::uint32_t> maxHeldUs_{};
+    PowerLock* next_{};
+};
+
+class PowerLockGuard
+{
+public:
+    explicit PowerLockGuard(PowerLock& lock)
+        : lock_{lock}
+    {
+        lock_.acquire();
+    }
+
+    PowerLockGuard(PowerLockGuard const&) = delete;
+
+    ~PowerLockGuard()
+    {
+        lock_.release();
+    }
+
+private:
+    PowerLock& lock_;
+};
+
+#endif
@@ -1,35 +1,27 @@
+#include <esp_log.h>
+
 #include "Application.hpp"
 #include "Sensors.hpp"
 
-Sensors::Sensors()
-    : i2cBus_{initExpandI2cBus()},
+static constexpr auto TAG{"Sensors"};
+
+Sensors::Sensors(std::uint32_t const i2cClock)
+    : bus_{GPIO_NUM_41, GPIO_NUM_40, i2cClock},
       radar_{initRadarSensor()},
-      tempHum_{initTempHumSensor()},
-      sensorTimer_{"sensors", {*this, &Sensors::readTempHumSensors}}
+      tempHum_{bus_.addDevice(tempHumAddress)},
+      sensorTimer_{"sensors", fn<&Sensors::poll>(*this)},
+      conversionTimer_{"aht20", fn<&Sensors::readTempHumMeasurement>(*this)},
+      radarDebounceTimer_{"radar", fn<&Sensors::radarSettled>(*this)},
+      radarSince_{esp_timer_get_time()},
+      radarState_{gpio_get_level(radarSensorGpio) != 0}
 {
-    readRadarSensor();
-    readTempHumSensors();
+    // the edge ring has to exist before the first interrupt
+    ESP_ERROR_CHECK(gpio_isr_handler_add(radarSensorGpio, &Sensors::radarSensorIsrHandler, this));
+    initTempHumSensor();
+    triggerTempHumMeasurement();
     sensorTimer_.start(Duration::millis(1000), true);
 }
 
-i2c_bus_handle_t Sensors::initExpandI2cBus()
-{
-    constexpr i2c_config_t config = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = GPIO_NUM_41,
-        .scl_io_num = GPIO_NUM_40,
-        .sda_pullup_en = GPIO_PULLUP_DISABLE,
-        .scl_pullup_en = GPIO_PULLUP_DISABLE,
-        .master{
-            .clk_speed = 100000
-        },
-        .clk_flags = 0
-    };
-    auto const handle = i2c_bus_create(I2C_NUM_0, &config);
-    assert(handle != nullptr);
-    return handle;
-}
-
 at581x_dev_handle_t Sensors::initRadarSensor()
 {
     at581x_default_cfg_t defaults = ATH581X_INITIALIZATION_CONFIG();
@@ -39,7 +31,7 @@ at581x_dev_handle_t Sensors::initRadarSensor()
     defaults.gain_cfg = AT581X_STAGE_GAIN_4;
     defaults.power_cfg = AT581X_POWER_91uA;
     at581x_i2c_config_t const config = {
-        .bus_inst = i2cBus_,
+        .bus_inst = bus_.handle(),
         .i2c_addr = AT581X_ADDRRES_0, // ggf. auf *_1 ändern, je nach Board
         .int_gpio_num = radarSensorGpio,
         .interrupt_level = 1,
@@ -59,42 +51,116 @@ at581x_dev_handle_t Sensors::initRadarSensor()
     ESP_ERROR_CHECK(gpio_config(&gpio));
 
     ESP_ERROR_CHECK(gpio_install_isr_service(0));
-    ESP_ERROR_CHECK(gpio_isr_handler_add(radarSensorGpio, &Sensors::radarSensorIsrHandler, this));
 
     return handle;
 }
 
-aht20_dev_handle_t Sensors::initTempHumSensor() const
+void Sensors::initTempHumSensor()
 {
-    aht20_i2c_config_t const i2c_conf = {
-        .bus_inst = i2cBus_,
-        .i2c_addr = AHT20_ADDRRES_0,
-    };
-    aht20_dev_handle_t handle;
-    ESP_ERROR_CHECK(aht20_new_sensor(&i2c_conf, &handle));
-    return handle;
+    // loads the calibration, queued ahead of the first measurement
+    static constexpr std::uint8_t initialize[]{0xBE, 0x08, 0x00};
+    bus_.submit(tempHum_, initialize, 0, {});
 }
 
 void Sensors::radarSensorIsrHandler(void* arg)
 {
+    // only records the edge, a burst of edges is drained by a single dispatch
     auto& self = *static_cast<Sensors*>(arg);
-    self.readRadarSensor();
-    Application::get().dispatchFromISR({self, &Sensors::fireRadarStateEvent});
+    self.radarEdges_.push({esp_timer_get_time(), gpio_get_level(radarSensorGpio) != 0});
+    if (!self.radarDrainPending_.exchange(true, std::memory_order_acq_rel)) {
+        if (!Application::get().dispatchFromISR(fn<&Sensors::drainRadarEdges>(self))) {
+            self.radarDrainPending_.store(false, std::memory_order_release);
+        }
+    }
+}
+
+Sensors::RadarStats Sensors::radarStats() const
+{
+    auto stats = radarStats_;
+    stats.overflows = radarEdges_.overflows();
+    return stats;
+}
+
+void Sensors::poll()
+{
+    // the ISR clears radarDrainPending_ when its dispatch fails, the edges would wait for the next edge otherwise
+    if (radarEdges_.size() > 0 && !radarDrainPending_.load(std::memory_order_acquire)) {
+        ++radarStats_.retried;
+        drainRadarEdges();
+    }
+    triggerTempHumMeasurement();
+}
+
+void Sensors::drainRadarEdges()
+{
+    radarDrainPending_.store(false, std::memory_order_release);
+
+    auto drained = false;
+    for (RadarEdge edge; radarEdges_.pop(edge); drained = true) {
+        ++radarStats_.edges;
+        if (radarCandidatePending_) ++radarStats_.suppressed;
+        radarCandidate_ = edge;
+        radarCandidatePending_ = true;
+    }
+    // every new edge restarts the debounce period
+    if (drained) radarDebounceTimer_.start(radarDebounceTime);
+}
+
+void Sensors::radarSettled()
+{
+    if (!radarCandidatePending_) return;
+
+    // a full ring drops the newest edges, so the last recorded level can be stale; the line has the final say
+    if (auto const level = gpio_get_level(radarSensorGpio) != 0; level != radarCandidate_.level) {
+        // a queued edge restarts the debounce once it is drained
+        if (radarEdges_.size() > 0) return;
+        radarCandidate_ = {esp_timer_get_time(), level};
+    }
+    radarCandidatePending_ = false;
+
+    if (radarCandidate_.level == radarState_) {
+        ++radarStats_.suppressed;
+        return;
+    }
+
+    auto const heldMs = static_cast<std::uint32_t>((radarCandidate_.timestamp - radarSince_) / 1000);
+    radarState_ = radarCandidate_.level;
+    radarSince_ = radarCandidate_.timestamp;
+    radarStateEvent(RadarChange{radarState_, radarSince_, heldMs});
+}
+
+void Sensors::triggerTempHumMeasurement()
+{
+    // the previous measurement is still in flight
+    if (conversionTimer_.active()) return;
+
+    static constexpr std::uint8_t trigger[]{0xAC, 0x33, 0x00};
+    if (!bus_.submit(tempHum_, trigger, 0, fn<&Sensors::tempHumTriggered>(*this))) {
+        ESP_LOGW(TAG, "temperature/humidity measurement not queued");
+    }
 }
 
-void Sensors::readRadarSensor()
+void Sensors::tempHumTriggered(esp_err_t const error, std::span<std::uint8_t const>)
 {
-    radarState_ = gpio_get_level(radarSensorGpio);
+    if (error == ESP_OK) conversionTimer_.start(tempHumConversionTime);
 }
 
-void Sensors::readTempHumSensors()
+void Sensors::readTempHumMeasurement()
 {
-    std::uint32_t temp_raw;
-    std::uint32_t RH_raw;
-    aht20_read_temperature_humidity(tempHum_, &temp_raw, &temperature_, &RH_raw, &humidity_);
+    bus_.submit(tempHum_, {}, 7, fn<&Sensors::tempHumRead>(*this));
 }
 
-void Sensors::fireRadarStateEvent()
+void Sensors::tempHumRead(esp_err_t const error, std::span<std::uint8_t const> const data)
 {
-    radarStateEvent(radarState_);
+    // status, 20 bit humidity, 20 bit temperature and a CRC; bit 7 of the status is set while still converting
+    if (error != ESP_OK || data.size() < 6) return;
+    if ((data[0] & 0x80) != 0) {
+        conversionTimer_.start(Duration::millis(10));
+        return;
+    }
+
+    auto const humidity = static_cast<std::uint32_t>(data[1]) << 12 | data[2] << 4 | data[3] >> 4;
+    auto const temperature = static_cast<std::uint32_t>(data[3] & 0x0F) << 16 | data[4] << 8 | data[5];
+    humidity_ = static_cast<float>(humidity) / (1 << 20) * 100.0f;
+    temperature_ = static_cast<float>(temperature) / (1 << 20) * 200.0f - 50.0f;
 }
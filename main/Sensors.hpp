@@ -1,43 +1,87 @@
 #ifndef AIVAS_RADARSENSOR_HPP
 #define AIVAS_RADARSENSOR_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <span>
+
 #include <at581x.h>
-#include <aht20.h>
 
 #include "Event.hpp"
+#include "I2cBus.hpp"
+#include "MpscQueue.hpp"
 #include "Singleton.hpp"
 #include "Timer.hpp"
 
 class Sensors : public Singleton<Sensors>
 {
     static constexpr auto radarSensorGpio = GPIO_NUM_21;
+    static constexpr std::uint8_t tempHumAddress = 0x38;
+    static constexpr auto tempHumConversionTime = Duration::millis(80);
+    // a level has to be stable this long before it becomes the radar state
+    static constexpr auto radarDebounceTime = Duration::millis(150);
+
+    struct RadarEdge
+    {
+        std::int64_t timestamp; // esp_timer time in µs
+        bool level;
+    };
 
 public:
-    Sensors();
+    struct RadarChange
+    {
+        bool present;
+        std::int64_t timestamp; // esp_timer time of the edge that started the new state, in µs
+        std::uint32_t heldMs;   // how long the previous state lasted
+    };
+
+    struct RadarStats
+    {
+        std::uint32_t edges;
+        std::uint32_t suppressed; // bounced or coalesced, not reported as a change
+        std::uint32_t overflows;  // lost in the ISR ring
+        std::uint32_t retried;    // drained by poll() after the ISR could not dispatch the drain
+    };
+
+    explicit Sensors(std::uint32_t i2cClock = I2cBus::standardMode);
     Sensors(Sensors const&) = delete;
 
     [[nodiscard]] bool radarState() const { return radarState_; }
     [[nodiscard]] float temperature() const { return temperature_; }
     [[nodiscard]] float humidity() const { return humidity_; }
+    [[nodiscard]] RadarStats radarStats() const;
 
-    SubscribeEvent<void(bool)> radarStateEvent;
+    SubscribeEvent<void(RadarChange)> radarStateEvent;
 
 private:
-    [[nodiscard]] static i2c_bus_handle_t initExpandI2cBus();
     [[nodiscard]] at581x_dev_handle_t initRadarSensor();
-    [[nodiscard]] aht20_dev_handle_t initTempHumSensor() const;
+    void initTempHumSensor();
 
     static void IRAM_ATTR radarSensorIsrHandler(void* arg);
 
-    void readRadarSensor();
-    void readTempHumSensors();
+    // runs every second, picks up radar edges stranded by a failed dispatch and triggers a measurement
+    void poll();
 
-    void fireRadarStateEvent();
+    void drainRadarEdges();
+    void radarSettled();
+    // AHT20 measurement: trigger, wait for the conversion with the bus released, then read the result
+    void triggerTempHumMeasurement();
+    void tempHumTriggered(esp_err_t error, std::span<std::uint8_t const> data);
+    void readTempHumMeasurement();
+    void tempHumRead(esp_err_t error, std::span<std::uint8_t const> data);
 
-    i2c_bus_handle_t i2cBus_;
+    I2cBus bus_;
     at581x_dev_handle_t radar_;
-    aht20_dev_handle_t tempHum_;
+    I2cBus::Device tempHum_;
     Timer sensorTimer_;
+    Timer conversionTimer_;
+    Timer radarDebounceTimer_;
+    MpscQueue<RadarEdge, 32> radarEdges_;
+    std::atomic<bool> radarDrainPending_{};
+    RadarEdge radarCandidate_{};
+    bool radarCandidatePending_{};
+    std::int64_t radarSince_{};
+    RadarStats radarStats_{};
     bool radarState_{};
     float temperature_{};
     float humidity_{};
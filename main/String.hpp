@@ -1,7 +1,13 @@
 #ifndef ESPIDF_IOT_STRING_HPP
 #define ESPIDF_IOT_STRING_HPP
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <span>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -9,26 +15,142 @@
 
 using String = std::pmr::string;
 
+/**
+ * @brief Null-terminated string with inline storage, as returned by str<Capacity>(...).
+ *
+ * Longer contents are truncated to the capacity.
+ */
+template<std::size_t Capacity>
+class StaticString
+{
+public:
+    [[nodiscard]] char const* c_str() const { return data_.data(); }
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] std::string_view view() const { return {data_.data(), size_}; }
+
+    // ReSharper disable once CppNonExplicitConversionOperator
+    operator std::string_view() const { return view(); } // NOLINT(*-explicit-constructor)
+
+    bool operator==(StaticString const& other) const { return view() == other.view(); }
+
+    // gives room for size characters plus terminator, the returned buffer is clamped to the capacity
+    std::span<char> prepare(std::size_t const size)
+    {
+        size_ = std::min(size, Capacity);
+        data_[size_] = '\0';
+        return {data_.data(), size_};
+    }
+
+private:
+    std::array<char, Capacity + 1> data_{};
+    std::size_t size_{};
+};
+
 namespace detail {
-    inline void str_append(String& result, std::string_view const& arg)
+    // numbers are formatted as is, strings viewed, anything else converted once through to_string
+    template<typename T>
+    auto format_arg(T const& arg)
+    {
+        if constexpr (std::is_convertible_v<T const&, std::string_view>) {
+            return std::string_view{arg};
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return static_cast<int>(arg);
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return arg;
+        } else {
+            using std::to_string;
+            return to_string(arg);
+        }
+    }
+
+    inline std::size_t formatted_size(std::string_view const str)
+    {
+        return str.size();
+    }
+
+    template<typename T>
+    requires(std::is_arithmetic_v<T>)
+    std::size_t formatted_size(T const number)
     {
-        result += arg;
+        std::array<char, 32> buffer; // NOLINT(*-pro-type-member-init)
+        return std::to_chars(buffer.begin(), buffer.end(), number).ptr - buffer.begin();
     }
 
     template<typename T>
-    requires(!std::is_convertible_v<T, std::string_view>)
-    void str_append(String& result, T arg)
+    requires(!std::is_arithmetic_v<T>)
+    std::size_t formatted_size(T const& str)
     {
-        using std::to_string;
-        result += to_string(arg);
+        return formatted_size(std::string_view{str});
+    }
+
+    inline char* format_to(char* pos, char* end, std::string_view const str)
+    {
+        return std::copy_n(str.data(), std::min<std::size_t>(str.size(), end - pos), pos);
+    }
+
+    template<typename T>
+    requires(std::is_arithmetic_v<T>)
+    char* format_to(char* pos, char* end, T const number)
+    {
+        if (auto const [ptr, ec] = std::to_chars(pos, end, number); ec == std::errc{}) return ptr;
+
+        // cut off by a truncating buffer, written as far as it fits
+        std::array<char, 32> buffer; // NOLINT(*-pro-type-member-init)
+        auto const ptr = std::to_chars(buffer.begin(), buffer.end(), number).ptr;
+        return format_to(pos, end, std::string_view{buffer.data(), static_cast<std::size_t>(ptr - buffer.begin())});
+    }
+
+    template<typename T>
+    requires(!std::is_arithmetic_v<T>)
+    char* format_to(char* pos, char* end, T const& str)
+    {
+        return format_to(pos, end, std::string_view{str});
+    }
+
+    // sizes all items first, then writes them into the single buffer handed out by prepare, which may be shorter
+    template<typename Prepare, typename... Items>
+    void format(Prepare&& prepare, Items const&... items)
+    {
+        auto const size = (std::size_t{} + ... + formatted_size(items));
+        std::span<char> const buffer = prepare(size);
+        auto pos = buffer.data();
+        auto const end = pos + buffer.size();
+        ((pos = format_to(pos, end, items)), ...);
     }
 } // namespace detail
 
+/**
+ * @brief Concatenates strings and numbers into a String with one exactly sized allocation.
+ */
 template<typename... Args>
-String str(Args&&... args)
+String str(std::pmr::memory_resource* resource, Args const&... args)
+{
+    String result{resource};
+    std::apply([&](auto const&... items) {
+        detail::format([&](std::size_t const size) {
+            result.resize(size);
+            return std::span{result};
+        }, items...);
+    }, std::tuple{detail::format_arg(args)...});
+    return result;
+}
+
+template<typename... Args>
+String str(Args const&... args)
+{
+    return str(std::pmr::get_default_resource(), args...);
+}
+
+/**
+ * @brief Concatenates strings and numbers into a StaticString without allocating, truncated to the capacity.
+ */
+template<std::size_t Capacity, typename... Args>
+StaticString<Capacity> str(Args const&... args)
 {
-    String result;
-    (detail::str_append(result, std::forward<Args>(args)), ...);
+    StaticString<Capacity> result;
+    std::apply([&](auto const&... items) {
+        detail::format([&](std::size_t const size) { return result.prepare(size); }, items...);
+    }, std::tuple{detail::format_arg(args)...});
     return result;
 }
 
@@ -54,6 +54,8 @@ public:
     Task(Task const&) = delete;
     ~Task();
 
+    [[nodiscard]] TaskHandle_t handle() const { return handle_; }
+
 private:
     Task(char const* name, uint32_t stackDepth, unsigned priority, int core, Runnable const& runnable);
 
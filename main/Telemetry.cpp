@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <array>
+
+#include <esp_log.h>
+
+#include "Delivery.hpp"
+#include "Governor.hpp"
+#include "JsonMessage.hpp"
+#include "Mqtt.hpp"
+#include "Telemetry.hpp"
+
+static constexpr auto TAG{"Telemetry"};
+
+Telemetry::Telemetry(Duration const interval)
+    : stateTopic_{Mqtt::get().topics().add("tele", "STATE")},
+      outbox_{&network_memory_resource},
+      metrics_{&network_memory_resource},
+      mqttConnected_{Mqtt::get().connectEvent.connect(fn<&Telemetry::flush>(*this), loopDelivery)},
+      flushTimer_{"telemetry", fn<&Telemetry::flush>(*this)}
+{
+    outbox_.reserve(outboxCapacity);
+    metrics_.reserve(metricCapacity);
+    flushTimer_.start(interval, true);
+    MemoryGovernor::get().addFeature("telemetry", MemoryGovernor::telemetryRank, fn<&Telemetry::shed>(*this));
+}
+
+void Telemetry::publish(TopicRegistry::Id const topic, std::string_view const payload, Policy const policy)
+{
+    if (shed_) {
+        ++stats_.dropped;
+        return;
+    }
+
+    auto const it = std::ranges::find(outbox_, topic, &Entry::topic);
+    if (it != outbox_.end()) {
+        if (it->pending) ++stats_.coalesced;
+        it->payload.assign(payload);
+        it->policy = policy;
+        it->pending = true;
+    } else if (outbox_.size() < outboxCapacity) {
+        outbox_.push_back({topic, String{payload, &network_memory_resource}, policy, true});
+    } else {
+        ++stats_.dropped;
+        return;
+    }
+    ++stats_.queued;
+}
+
+void Telemetry::metric(std::string_view const name, double const value)
+{
+    if (shed_) return;
+
+    if (auto const it = std::ranges::find(metrics_, name, &Metric::name); it != metrics_.end()) {
+        it->value = value;
+    } else if (metrics_.size() < metricCapacity) {
+        metrics_.push_back({String{name, &network_memory_resource}, value});
+    } else {
+        ESP_LOGW(TAG, "no room for metric %.*s", name.length(), name.data());
+        return;
+    }
+    metricsPending_ = true;
+}
+
+void Telemetry::flush()
+{
+    auto& mqtt = Mqtt::get();
+    if (!mqtt.connected()) return;
+    ++stats_.flushes;
+
+    if (metricsPending_) {
+        std::array<char, 512> buffer; // NOLINT(*-pro-type-member-init)
+        detail::JsonWriter writer{buffer};
+        writer.raw("{");
+        for (std::size_t i = 0; i < metrics_.size(); ++i) {
+            writer.raw(i == 0 ? "\"" : ",\"");
+            writer.raw(metrics_[i].name);
+            writer.raw("\":");
+            writer.value(metrics_[i].value);
+        }
+        writer.raw("}");
+        if (writer.result().empty()) {
+            ESP_LOGE(TAG, "%u metrics exceed %u bytes", metrics_.size(), buffer.size());
+        } else if (mqtt.publish(stateTopic_, writer.result(), false, 0)) {
+            metricsPending_ = false;
+            ++stats_.published;
+        }
+    }
+
+    for (auto& entry: outbox_) {
+        if (!entry.pending) continue;
+        if (!mqtt.publish(entry.topic, entry.payload, entry.policy.retain, entry.policy.qos)) break;
+        entry.pending = false;
+        ++stats_.published;
+    }
+}
+
+void Telemetry::shed(bool const shed)
+{
+    shed_ = shed;
+    if (!shed) {
+        outbox_.reserve(outboxCapacity);
+        metrics_.reserve(metricCapacity);
+        return;
+    }
+
+    outbox_.clear();
+    outbox_.shrink_to_fit();
+    metrics_.clear();
+    metrics_.shrink_to_fit();
+    metricsPending_ = false;
+}
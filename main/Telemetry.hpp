@@ -0,0 +1,80 @@
+#ifndef AIVAS_IOT_TELEMETRY_HPP
+#define AIVAS_IOT_TELEMETRY_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "Event.hpp"
+#include "Singleton.hpp"
+#include "String.hpp"
+#include "Time.hpp"
+#include "Timer.hpp"
+#include "TopicRegistry.hpp"
+
+/**
+ * @brief Collects telemetry in a bounded outbox and publishes it once per interval.
+ *
+ * Messages to the same topic are coalesced, only the last payload is sent. Metrics are batched into a single
+ * JSON object on tele/<base>/STATE. Whatever could not be sent stays in the outbox until the next flush, which
+ * also happens right after the MQTT connection is (re-)established. Must be used from the Application loop.
+ */
+class Telemetry : public Singleton<Telemetry>
+{
+    static constexpr std::size_t outboxCapacity = 16;
+    static constexpr std::size_t metricCapacity = 16;
+
+public:
+    struct Policy
+    {
+        int qos;
+        bool retain;
+    };
+
+    struct Stats
+    {
+        std::uint32_t queued;
+        std::uint32_t coalesced;
+        std::uint32_t dropped;
+        std::uint32_t published;
+        std::uint32_t flushes;
+    };
+
+    explicit Telemetry(Duration interval);
+    Telemetry(Telemetry const&) = delete;
+
+    void publish(TopicRegistry::Id topic, std::string_view payload, Policy policy = {});
+    void metric(std::string_view name, double value);
+
+    void flush();
+
+    [[nodiscard]] Stats stats() const { return stats_; }
+
+private:
+    struct Entry
+    {
+        TopicRegistry::Id topic;
+        String payload;
+        Policy policy;
+        bool pending;
+    };
+
+    struct Metric
+    {
+        String name;
+        double value;
+    };
+
+    void shed(bool shed);
+
+    TopicRegistry::Id const stateTopic_;
+    std::pmr::vector<Entry> outbox_;
+    std::pmr::vector<Metric> metrics_;
+    bool metricsPending_{};
+    bool shed_{};
+    Stats stats_{};
+    Subscription mqttConnected_;
+    Timer flushTimer_;
+};
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <freertos/FreeRTOS.h>
 
+#include <algorithm>
+#include <compare>
 #include <cstdint>
 
 class Duration
@@ -15,6 +17,8 @@ public:
 
     [[nodiscard]] constexpr uint32_t millis() const { return millis_; }
 
+    constexpr auto operator<=>(Duration const&) const = default;
+
     [[nodiscard]] uint32_t ticks() const
     {
         if (millis_ == 0) return 0;
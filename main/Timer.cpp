@@ -5,42 +5,71 @@
 
 Timer::Timer(char const* name, Handler const& handler)
     : name_{name},
-      handler_{handler},
-      handle_{
-          xTimerCreate(
-              name_, 1, false, this,
-              [](auto timer) { static_cast<Timer*>(pvTimerGetTimerID(timer))->timedOut(); }
-          )
-      }
+      handler_{handler}
 {
-    assert(handle_ != nullptr);
 }
 
 Timer::~Timer()
 {
-    xTimerDelete(handle_, portMAX_DELAY);
+    stop();
 }
 
-bool Timer::active() const
+void Timer::start(Duration const timeout, bool const repeat)
 {
-    return xTimerIsTimerActive(handle_);
+    period_ = repeat ? timeout.ticks() : 0;
+    if (Application::get().timerWheel().start(*this, timeout.ticks())) {
+        Application::get().wakeup();
+    }
+}
+
+void Timer::stop()
+{
+    Application::get().timerWheel().stop(*this);
+}
+
+void Timer::timedOut() const
+{
+    handler_();
+}
+
+PreciseTimer::PreciseTimer(char const* name, Handler const& handler)
+    : handler_{handler}
+{
+    esp_timer_create_args_t const args{
+        .callback = [](auto arg) { static_cast<PreciseTimer*>(arg)->timedOut(); },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = name,
+        .skip_unhandled_events = true
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&args, &handle_));
+}
+
+PreciseTimer::~PreciseTimer()
+{
+    stop();
+    esp_timer_delete(handle_);
 }
 
-void Timer::start(Duration const timeout, bool const repeat) const
+bool PreciseTimer::active() const
 {
-    vTimerSetReloadMode(handle_, repeat);
-    xTimerChangePeriod(handle_, timeout.ticks(), portMAX_DELAY);
-    xTimerStart(handle_, portMAX_DELAY);
+    return esp_timer_is_active(handle_);
 }
 
-void Timer::stop() const
+void PreciseTimer::start(std::uint64_t const timeoutUs) const
+{
+    stop();
+    ESP_ERROR_CHECK(esp_timer_start_once(handle_, timeoutUs));
+}
+
+void PreciseTimer::stop() const
 {
     if (active()) {
-        xTimerStop(handle_, portMAX_DELAY);
+        esp_timer_stop(handle_);
     }
 }
 
-void Timer::timedOut() const
+void PreciseTimer::timedOut() const
 {
-    Application::get().dispatch(handler_);
+    Application::get().dispatch(handler_, Application::Lane::high, Application::Overflow::coalesce);
 }
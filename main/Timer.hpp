@@ -1,13 +1,23 @@
 #ifndef ESPIDF_IOT_SOFTTIMER_HPP
 #define ESPIDF_IOT_SOFTTIMER_HPP
 
-#include <freertos/timers.h>
+#include <cstdint>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
 
 #include "Function.hpp"
 #include "Time.hpp"
 
+class TimerWheel;
+
+/**
+ * @brief Millisecond timer on the Application's timing wheel, the handler runs on the Application loop.
+ */
 class Timer
 {
+    friend class TimerWheel;
+
     using Handler = Function<void()>;
 
 public:
@@ -15,17 +25,45 @@ public:
     Timer(Timer const&) = delete;
     ~Timer();
 
+    [[nodiscard]] bool active() const { return active_; }
+
+    void start(Duration timeout, bool repeat = false);
+    void stop();
+
+private:
+    void timedOut() const;
+
+    char const* name_;
+    Handler handler_;
+    Timer* next_{};
+    Timer* prev_{};
+    TickType_t deadline_{};
+    TickType_t period_{};
+    bool active_{};
+};
+
+/**
+ * @brief Microsecond one-shot timer backed by esp_timer, the handler is dispatched to the Application loop.
+ */
+class PreciseTimer
+{
+    using Handler = Function<void()>;
+
+public:
+    PreciseTimer(char const* name, Handler const& handler);
+    PreciseTimer(PreciseTimer const&) = delete;
+    ~PreciseTimer();
+
     [[nodiscard]] bool active() const;
 
-    void start(Duration timeout, bool repeat = false) const;
+    void start(std::uint64_t timeoutUs) const;
     void stop() const;
 
 private:
     void timedOut() const;
 
-    char const* name_;
     Handler handler_;
-    TimerHandle_t handle_;
+    esp_timer_handle_t handle_{};
 };
 
 #endif
@@ -0,0 +1,118 @@
+#include "Timer.hpp"
+#include "TimerWheel.hpp"
+
+static bool expired(TickType_t const deadline, TickType_t const now)
+{
+    return static_cast<std::int32_t>(deadline - now) <= 0;
+}
+
+TimerWheel::TimerWheel()
+    : current_{xTaskGetTickCount()}
+{
+}
+
+bool TimerWheel::start(Timer& timer, TickType_t const ticks)
+{
+    taskENTER_CRITICAL(&lock_);
+    if (timer.active_) unlink(timer);
+    // the current tick may already have been polled
+    timer.deadline_ = xTaskGetTickCount() + std::max<TickType_t>(ticks, 1);
+    link(timer);
+
+    auto wakeup = !earliestValid_;
+    if (active_ == 1 || (earliestValid_ && expired(timer.deadline_, earliest_))) {
+        earliest_ = timer.deadline_;
+        earliestValid_ = true;
+        wakeup = true;
+    }
+    taskEXIT_CRITICAL(&lock_);
+    return wakeup;
+}
+
+void TimerWheel::stop(Timer& timer)
+{
+    taskENTER_CRITICAL(&lock_);
+    if (timer.active_) unlink(timer);
+    taskEXIT_CRITICAL(&lock_);
+}
+
+Duration TimerWheel::nextTimeout()
+{
+    taskENTER_CRITICAL(&lock_);
+    if (active_ > 0 && !earliestValid_) {
+        // only rescanned after the earliest timer fired or was stopped
+        auto first = true;
+        for (auto const head: slots_) {
+            for (auto timer = head; timer != nullptr; timer = timer->next_) {
+                if (first || expired(timer->deadline_, earliest_)) earliest_ = timer->deadline_;
+                first = false;
+            }
+        }
+        earliestValid_ = true;
+    }
+    auto const remaining = static_cast<std::int32_t>(earliest_ - xTaskGetTickCount());
+    auto const active = active_;
+    taskEXIT_CRITICAL(&lock_);
+
+    if (active == 0) return Duration::max();
+    return remaining > 0 ? Duration::ticks(remaining) : Duration::none();
+}
+
+void TimerWheel::poll()
+{
+    auto const now = xTaskGetTickCount();
+    auto const steps = std::min<TickType_t>(now - current_, slotCount);
+
+    for (TickType_t step = 1; step <= steps; ++step) {
+        auto const slot = (current_ + step) % slotCount;
+        // handlers may start or stop timers, so the slot is re-examined after each one
+        while (auto const timer = popExpired(now, slot)) {
+            timer->timedOut();
+        }
+    }
+    current_ = now;
+}
+
+void TimerWheel::link(Timer& timer)
+{
+    auto& head = slots_[timer.deadline_ % slotCount];
+    timer.prev_ = nullptr;
+    timer.next_ = head;
+    if (head != nullptr) head->prev_ = &timer;
+    head = &timer;
+    timer.active_ = true;
+    ++active_;
+}
+
+void TimerWheel::unlink(Timer& timer)
+{
+    if (timer.prev_ != nullptr) {
+        timer.prev_->next_ = timer.next_;
+    } else {
+        slots_[timer.deadline_ % slotCount] = timer.next_;
+    }
+    if (timer.next_ != nullptr) timer.next_->prev_ = timer.prev_;
+    timer.next_ = timer.prev_ = nullptr;
+    timer.active_ = false;
+    --active_;
+
+    if (timer.deadline_ == earliest_) earliestValid_ = false;
+}
+
+Timer* TimerWheel::popExpired(TickType_t const now, std::size_t const slot)
+{
+    taskENTER_CRITICAL(&lock_);
+    auto timer = slots_[slot];
+    while (timer != nullptr && !expired(timer->deadline_, now)) timer = timer->next_;
+    if (timer != nullptr) {
+        unlink(*timer);
+        if (timer->period_ > 0) {
+            // periodic timers keep their phase unless they fell behind by more than a period
+            timer->deadline_ = expired(timer->deadline_ + timer->period_, now) ? now + timer->period_
+                                                                               : timer->deadline_ + timer->period_;
+            link(*timer);
+        }
+    }
+    taskEXIT_CRITICAL(&lock_);
+    return timer;
+}
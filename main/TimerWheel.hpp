@@ -0,0 +1,51 @@
+#ifndef AIVAS_IOT_TIMERWHEEL_HPP
+#define AIVAS_IOT_TIMERWHEEL_HPP
+
+#include <array>
+#include <cstddef>
+
+#include <freertos/FreeRTOS.h>
+
+#include "Time.hpp"
+
+class Timer;
+
+/**
+ * @brief Hashed timing wheel with one slot per tick, driven by the Application loop.
+ *
+ * Timers are linked intrusively into the slot of their deadline, so start and stop are O(1). Deadlines further away
+ * than one revolution simply stay in their slot until the wheel comes around. All timers due up to the current tick
+ * fire in a single pass of poll().
+ */
+class TimerWheel
+{
+    static constexpr std::size_t slotCount = 256;
+
+public:
+    TimerWheel();
+    TimerWheel(TimerWheel const&) = delete;
+
+    // returns true if a sleeping loop has to be woken to pick up the new deadline
+    bool start(Timer& timer, TickType_t ticks);
+    void stop(Timer& timer);
+
+    // time until the earliest deadline, to be used as wait timeout of the loop
+    [[nodiscard]] Duration nextTimeout();
+
+    // fires all timers whose deadline passed
+    void poll();
+
+private:
+    void link(Timer& timer);
+    void unlink(Timer& timer);
+    Timer* popExpired(TickType_t now, std::size_t slot);
+
+    std::array<Timer*, slotCount> slots_{};
+    TickType_t current_;
+    TickType_t earliest_{};
+    bool earliestValid_{};
+    std::size_t active_{};
+    portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "TopicRegistry.hpp"
+
+TopicRegistry::TopicRegistry(std::string_view const baseTopic, std::pmr::memory_resource* resource)
+    : baseTopic_{baseTopic, resource},
+      topics_{resource}
+{
+}
+
+TopicRegistry::Id TopicRegistry::add(std::string_view const prefix, std::string_view const name)
+{
+    auto topic = str(topics_.get_allocator().resource(), prefix, "/", baseTopic_, "/", name);
+    if (auto const it = std::ranges::find(topics_, topic); it != topics_.end()) {
+        return static_cast<Id>(it - topics_.begin());
+    }
+
+    assert(topics_.size() <= std::numeric_limits<Id>::max());
+    topics_.push_back(std::move(topic));
+    return static_cast<Id>(topics_.size() - 1);
+}
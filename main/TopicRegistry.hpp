@@ -0,0 +1,35 @@
+#ifndef AIVAS_IOT_TOPICREGISTRY_HPP
+#define AIVAS_IOT_TOPICREGISTRY_HPP
+
+#include <cstdint>
+#include <deque>
+#include <string_view>
+
+#include "String.hpp"
+
+/**
+ * @brief Full MQTT topics built once from prefix, base topic and name, referred to by small integer ids.
+ *
+ * Topics are meant to be added during startup, the strings never move so c_str() stays valid.
+ */
+class TopicRegistry
+{
+public:
+    using Id = std::uint8_t;
+
+    TopicRegistry(std::string_view baseTopic, std::pmr::memory_resource* resource);
+    TopicRegistry(TopicRegistry const&) = delete;
+
+    [[nodiscard]] std::string_view baseTopic() const { return baseTopic_; }
+
+    // <prefix>/<base topic>/<name>, adding the same topic twice returns the same id
+    Id add(std::string_view prefix, std::string_view name);
+
+    [[nodiscard]] String const& operator[](Id const id) const { return topics_[id]; }
+
+private:
+    String baseTopic_;
+    std::pmr::deque<String> topics_;
+};
+
+#endif
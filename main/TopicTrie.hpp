@@ -0,0 +1,215 @@
+#ifndef AIVAS_IOT_TOPICTRIE_HPP
+#define AIVAS_IOT_TOPICTRIE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "String.hpp"
+
+/**
+ * @brief Maps MQTT topic filters, including + and # wildcards, to handlers.
+ *
+ * Filters are stored one node per level, levels are interned so matching a topic costs one hash lookup per level
+ * plus the wildcard branches. Topics starting with $ are not matched by wildcards on the first level.
+ */
+template<typename Handler>
+class TopicTrie
+{
+    static constexpr std::uint32_t none = ~std::uint32_t{};
+
+    struct SegmentHash
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view const segment) const
+        {
+            return std::hash<std::string_view>{}(segment);
+        }
+    };
+
+    struct Child
+    {
+        std::uint32_t segment;
+        std::uint32_t node;
+
+        bool operator<(Child const& other) const { return segment < other.segment; }
+    };
+
+    struct Node
+    {
+        explicit Node(std::pmr::memory_resource* resource)
+            : children{resource},
+              handlers{resource}
+        {
+        }
+
+        std::pmr::vector<Child> children; // sorted by segment
+        std::uint32_t plus{none};
+        std::uint32_t hash{none};
+        std::pmr::vector<Handler> handlers;
+    };
+
+public:
+    explicit TopicTrie(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : resource_{resource},
+          nodes_{resource},
+          segments_{resource},
+          filters_{resource}
+    {
+        nodes_.emplace_back(resource_);
+    }
+
+    TopicTrie(TopicTrie const&) = delete;
+
+    // # only as the last level, + and # only as a whole level
+    static bool valid(std::string_view const filter)
+    {
+        if (filter.empty()) return false;
+        for (std::string_view rest = filter;;) {
+            auto const pos = rest.find('/');
+            auto const segment = rest.substr(0, pos);
+            auto const last = pos == std::string_view::npos;
+
+            if (segment == "#") {
+                if (!last) return false;
+            } else if (segment != "+" && segment.find_first_of("+#") != std::string_view::npos) {
+                return false;
+            }
+
+            if (last) return true;
+            rest = rest.substr(pos + 1);
+        }
+    }
+
+    // returns true if the filter was not subscribed before, false for duplicates and invalid filters
+    bool insert(std::string_view const filter, Handler const& handler)
+    {
+        // checked up front, so an invalid filter leaves no nodes behind
+        if (!valid(filter)) return false;
+
+        std::uint32_t index{};
+        for (std::string_view rest = filter;;) {
+            auto const pos = rest.find('/');
+            auto const segment = rest.substr(0, pos);
+            auto const last = pos == std::string_view::npos;
+
+            if (segment == "#") {
+                index = descend(index, &Node::hash);
+            } else if (segment == "+") {
+                index = descend(index, &Node::plus);
+            } else {
+                index = child(index, intern(segment));
+            }
+
+            if (last) break;
+            rest = rest.substr(pos + 1);
+        }
+
+        auto& handlers = nodes_[index].handlers;
+        handlers.push_back(handler);
+        if (handlers.size() > 1) return false;
+        filters_.emplace_back(filter);
+        return true;
+    }
+
+    // calls visitor with every handler whose filter matches the topic, returns the number of handlers
+    template<typename Visitor>
+    std::size_t match(std::string_view const topic, Visitor&& visitor) const
+    {
+        std::size_t count{};
+        matchFrom(0, topic, false, true, visitor, count);
+        return count;
+    }
+
+    // distinct filters in subscription order
+    [[nodiscard]] std::pmr::vector<String> const& filters() const { return filters_; }
+
+private:
+    std::uint32_t descend(std::uint32_t const index, std::uint32_t Node::* wildcard)
+    {
+        if (nodes_[index].*wildcard == none) {
+            auto const node = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.emplace_back(resource_);
+            nodes_[index].*wildcard = node;
+        }
+        return nodes_[index].*wildcard;
+    }
+
+    std::uint32_t child(std::uint32_t const index, std::uint32_t const segment)
+    {
+        auto& children = nodes_[index].children;
+        auto const it = std::lower_bound(children.begin(), children.end(), Child{segment, none});
+        if (it != children.end() && it->segment == segment) return it->node;
+
+        auto const node = static_cast<std::uint32_t>(nodes_.size());
+        children.insert(it, {segment, node});
+        nodes_.emplace_back(resource_);
+        return node;
+    }
+
+    [[nodiscard]] std::uint32_t findChild(Node const& node, std::uint32_t const segment) const
+    {
+        auto const it = std::lower_bound(node.children.begin(), node.children.end(), Child{segment, none});
+        return it != node.children.end() && it->segment == segment ? it->node : none;
+    }
+
+    std::uint32_t intern(std::string_view const segment)
+    {
+        auto const [it, inserted] = segments_.try_emplace(String{segment, resource_}, segments_.size());
+        return it->second;
+    }
+
+    [[nodiscard]] std::uint32_t find(std::string_view const segment) const
+    {
+        auto const it = segments_.find(segment);
+        return it != segments_.end() ? it->second : none;
+    }
+
+    template<typename Visitor>
+    void matchFrom(std::uint32_t const index, std::string_view const rest, bool const atEnd, bool const root,
+                   Visitor& visitor, std::size_t& count) const
+    {
+        auto const& node = nodes_[index];
+        auto const wildcards = !(root && rest.starts_with('$'));
+
+        // a trailing # also matches the parent level
+        if (node.hash != none && wildcards) deliver(nodes_[node.hash], visitor, count);
+        if (atEnd) {
+            deliver(node, visitor, count);
+            return;
+        }
+
+        auto const pos = rest.find('/');
+        auto const next = pos == std::string_view::npos ? std::string_view{} : rest.substr(pos + 1);
+        auto const nextAtEnd = pos == std::string_view::npos;
+
+        if (auto const segment = find(rest.substr(0, pos)); segment != none) {
+            if (auto const child = findChild(node, segment); child != none) {
+                matchFrom(child, next, nextAtEnd, false, visitor, count);
+            }
+        }
+        if (node.plus != none && wildcards) matchFrom(node.plus, next, nextAtEnd, false, visitor, count);
+    }
+
+    template<typename Visitor>
+    static void deliver(Node const& node, Visitor& visitor, std::size_t& count)
+    {
+        for (auto const& handler: node.handlers) {
+            visitor(handler);
+        }
+        count += node.handlers.size();
+    }
+
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<Node> nodes_;
+    std::pmr::unordered_map<String, std::uint32_t, SegmentHash, std::equal_to<>> segments_;
+    std::pmr::vector<String> filters_;
+};
+
+#endif
@@ -28,8 +28,9 @@ struct WebSocket::Helpers
 };
 
 WebSocket::WebSocket(std::string_view const host, std::uint16_t const port, std::string_view const path,
-                     Callback const& connectCallback, Callback const& disconnectCallback)
-    : uri_{str("ws://", host, ":", port, path)},
+                     Callback const& connectCallback, Callback const& disconnectCallback,
+                     std::pmr::memory_resource* resource)
+    : uri_{str(resource, "ws://", host, ":", port, path)},
       connectCallback_{connectCallback},
       disconnectCallback_{disconnectCallback}
 {
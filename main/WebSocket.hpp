@@ -19,7 +19,8 @@ class WebSocket
 
 public:
     WebSocket(std::string_view host, std::uint16_t port, std::string_view path,
-              Callback const& connectCallback = []{}, Callback const& disconnectCallback = []{});
+              Callback const& connectCallback = []{}, Callback const& disconnectCallback = []{},
+              std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     ~WebSocket();
 
     [[nodiscard]] bool connected() const { return connected_; }
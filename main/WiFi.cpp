@@ -9,14 +9,9 @@
 
 static constexpr auto TAG = "WiFI";
 
-static String toHostname(std::string_view clientId)
+static WiFi::Hostname toHostname(std::string_view clientId)
 {
-    String hostname{clientId};
-    std::ranges::transform(
-        std::as_const(hostname), hostname.begin(),
-        [](auto c) { return std::tolower(c); }
-    );
-    return str("iot-", clientId);
+    return str<WiFi::hostnameCapacity>("iot-", clientId);
 }
 
 template<std::size_t N>
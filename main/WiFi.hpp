@@ -21,6 +21,10 @@ class WiFi : public Singleton<WiFi>
     friend Helpers;
 
 public:
+    static constexpr std::size_t hostnameCapacity = 32; // as accepted by esp_netif_set_hostname
+
+    using Hostname = StaticString<hostnameCapacity>;
+
     WiFi(std::string_view ssid, std::string_view password);
 
     [[nodiscard]] std::string_view ssid() const { return ssid_; }
@@ -40,7 +44,7 @@ private:
 
     std::string_view ssid_;
     std::string_view password_;
-    String const hostname_;
+    Hostname const hostname_;
     // SoftTimer reconnectTimer_;
     esp_netif_t* handle_{};
     bool connected_{};
@@ -0,0 +1,136 @@
+#include "Application.hpp"
+#include "WorkerPool.hpp"
+
+static constexpr char const* workerNames[]{"worker0", "worker1"};
+static_assert(std::size(workerNames) >= portNUM_PROCESSORS);
+
+WorkerPool::WorkerPool(std::size_t const capacity, unsigned const priority)
+{
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        auto& worker = workers_[i];
+        worker.pool = this;
+        worker.index = i;
+        worker.jobs.resize(capacity);
+    }
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        auto& worker = workers_[i];
+        worker.task.emplace(workerNames[i], fn(worker, &Worker::run), StackDepth{6144}, Priority{priority},
+                            Core{static_cast<int>(i)});
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    running_ = false;
+    for (auto& worker: workers_) {
+        xTaskNotifyGive(worker.task->handle());
+        worker.task.reset();
+    }
+}
+
+bool WorkerPool::submit(Runnable const& job, Runnable const& continuation)
+{
+    // jobs spawned by a worker stay local, others are distributed round robin
+    auto target = current();
+    if (target == nullptr) {
+        target = &workers_[nextWorker_.fetch_add(1, std::memory_order_relaxed) % workerCount];
+    }
+
+    if (!target->pushBack({job, continuation})) {
+        target->rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    wakeup(*target);
+    return true;
+}
+
+WorkerPool::Stats WorkerPool::stats(std::size_t const worker) const
+{
+    auto const& state = workers_[worker];
+    return {
+        state.executed.load(std::memory_order_relaxed),
+        state.stolen.load(std::memory_order_relaxed),
+        state.rejected.load(std::memory_order_relaxed),
+    };
+}
+
+WorkerPool::Worker* WorkerPool::current()
+{
+    auto const handle = xTaskGetCurrentTaskHandle();
+    for (auto& worker: workers_) {
+        if (worker.task && worker.task->handle() == handle) return &worker;
+    }
+    return nullptr;
+}
+
+bool WorkerPool::take(Worker& worker, Job& job)
+{
+    if (worker.popBack(job)) return true;
+
+    for (std::size_t i = 1; i < workerCount; ++i) {
+        if (workers_[(worker.index + i) % workerCount].popFront(job)) {
+            worker.stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkerPool::wakeup(Worker const& target)
+{
+    xTaskNotifyGive(target.task->handle());
+
+    // a busy target leaves the job to be stolen by an idle worker
+    if (!target.idle.load(std::memory_order_acquire)) {
+        for (auto const& worker: workers_) {
+            if (&worker != &target && worker.idle.load(std::memory_order_acquire)) {
+                xTaskNotifyGive(worker.task->handle());
+                break;
+            }
+        }
+    }
+}
+
+bool WorkerPool::Worker::pushBack(Job const& job)
+{
+    taskENTER_CRITICAL(&lock);
+    auto const pushed = head - tail < jobs.size();
+    if (pushed) jobs[head++ % jobs.size()] = job;
+    taskEXIT_CRITICAL(&lock);
+    return pushed;
+}
+
+bool WorkerPool::Worker::popBack(Job& job)
+{
+    taskENTER_CRITICAL(&lock);
+    auto const popped = head != tail;
+    if (popped) job = jobs[--head % jobs.size()];
+    taskEXIT_CRITICAL(&lock);
+    return popped;
+}
+
+bool WorkerPool::Worker::popFront(Job& job)
+{
+    taskENTER_CRITICAL(&lock);
+    auto const popped = head != tail;
+    if (popped) job = jobs[tail++ % jobs.size()];
+    taskEXIT_CRITICAL(&lock);
+    return popped;
+}
+
+void WorkerPool::Worker::run()
+{
+    while (pool->running_) {
+        if (Job job; pool->take(*this, job)) {
+            job.work();
+            executed.fetch_add(1, std::memory_order_relaxed);
+            if (job.continuation) Application::get().dispatch(job.continuation);
+            continue;
+        }
+
+        idle.store(true, std::memory_order_release);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        idle.store(false, std::memory_order_release);
+    }
+}
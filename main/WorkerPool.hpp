@@ -0,0 +1,81 @@
+#ifndef AIVAS_IOT_WORKERPOOL_HPP
+#define AIVAS_IOT_WORKERPOOL_HPP
+
+#include <array>
+#include <atomic>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+
+#include "Function.hpp"
+#include "Task.hpp"
+
+/**
+ * @brief Background workers, one per core, that steal jobs from each other when idle.
+ *
+ * Jobs submitted from a worker go to that worker's own deque and are popped LIFO, idle workers steal FIFO from the
+ * other end. An optional continuation is dispatched to the Application loop after the job finished.
+ */
+class WorkerPool
+{
+    static constexpr std::size_t workerCount = portNUM_PROCESSORS;
+
+public:
+    using Runnable = Function<void()>;
+
+    struct Stats
+    {
+        std::size_t executed;
+        std::size_t stolen;
+        std::size_t rejected;
+    };
+
+    explicit WorkerPool(std::size_t capacity, unsigned priority);
+    WorkerPool(WorkerPool const&) = delete;
+    ~WorkerPool();
+
+    bool submit(Runnable const& job, Runnable const& continuation = {});
+
+    [[nodiscard]] static constexpr std::size_t size() { return workerCount; }
+    [[nodiscard]] Stats stats(std::size_t worker) const;
+
+private:
+    struct Job
+    {
+        Runnable work;
+        Runnable continuation;
+    };
+
+    struct Worker
+    {
+        WorkerPool* pool{};
+        std::size_t index{};
+        std::pmr::vector<Job> jobs;
+        std::size_t head{};
+        std::size_t tail{};
+        mutable portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+        std::atomic<bool> idle{};
+        std::atomic<std::size_t> executed{};
+        std::atomic<std::size_t> stolen{};
+        std::atomic<std::size_t> rejected{};
+        std::optional<Task> task;
+
+        bool pushBack(Job const& job);
+        bool popBack(Job& job);
+        bool popFront(Job& job);
+
+        void run();
+    };
+
+    [[nodiscard]] Worker* current();
+    bool take(Worker& worker, Job& job);
+    void wakeup(Worker const& target);
+
+    std::array<Worker, workerCount> workers_;
+    std::atomic<std::size_t> nextWorker_{};
+    bool volatile running_{true};
+};
+
+#endif